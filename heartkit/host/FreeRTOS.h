@@ -0,0 +1,34 @@
+/**
+ * @file FreeRTOS.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host stand-in for FreeRTOS (host build only)
+ * The host build drives the pipeline from a plain loop so there is no
+ * scheduler- only the types and config used by the app are provided.
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __HOST_FREERTOS_H
+#define __HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define configTICK_RATE_HZ (1000)
+#define configAPPLICATION_ALLOCATED_HEAP (0)
+#define INCLUDE_uxTaskGetStackHighWaterMark (0)
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdPASS (pdTRUE)
+#define pdFAIL (pdFALSE)
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+
+#endif // __HOST_FREERTOS_H
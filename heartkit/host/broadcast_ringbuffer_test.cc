@@ -0,0 +1,129 @@
+/**
+ * @file broadcast_ringbuffer_test.cc
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host property test for BroadcastRingBuffer (typed_ringbuffer.h)
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Randomized operation sequences on a two reader ring are checked against
+ * one std::deque model per reader. Reader 0 holds the producer back when
+ * full, reader 1 is in DropMask and is skipped ahead (and counted) instead,
+ * as the metrics and TX readers of rbEcgSegOut are.
+ *
+ */
+#include <algorithm>
+#include <random>
+#include "typed_ringbuffer.h"
+#include "ringbuffer_test.h"
+
+static constexpr uint32_t BlockingReader = 0;
+static constexpr uint32_t DroppingReader = 1;
+
+template <typename T, uint32_t N, uint32_t V, uint32_t M>
+static void
+check_broadcast_ring(BroadcastRingBuffer<T, N, 2, V, M> &rb, const model_t *models, const uint32_t *drops) {
+    T out[N];
+    CHECK(rb.space() == N - models[BlockingReader].size());
+    for (uint32_t r = 0; r < 2; r++) {
+        CHECK(rb.len(r) == models[r].size());
+        CHECK(rb.dropped(r) == drops[r]);
+        CHECK(rb.peek(r, out, N) == models[r].size());
+        for (size_t i = 0; i < models[r].size(); i++) {
+            CHECK(out[i] == (T)models[r][i]);
+        }
+    }
+}
+
+/**
+ * @brief Random push/pop/peek_at/view/seek/flush per reader against deque models
+ *
+ * @tparam T Element type
+ * @tparam N Capacity
+ * @tparam V View length
+ * @param seed Random seed
+ * @param ops Number of operations
+ */
+template <typename T, uint32_t N, uint32_t V>
+static void
+test_broadcast_ring(uint32_t seed, uint32_t ops) {
+    static BroadcastRingBuffer<T, N, 2, V, 1 << DroppingReader> rb;
+    std::mt19937 rng(seed);
+    uint32_t mask = elem_mask(sizeof(T));
+    T data[N + 3];
+    model_t models[2];
+    uint32_t drops[2] = {rb.dropped(BlockingReader), rb.dropped(DroppingReader)};
+    uint32_t next = rng();
+
+    // Ring is reused across seeds- start each sequence at a different offset
+    rb.flush(BlockingReader);
+    rb.flush(DroppingReader);
+    testSeed = seed;
+    for (testOp = 0; testOp < ops; testOp++) {
+        uint32_t reader = rng() % 2;
+        model_t &m = models[reader];
+        size_t len = rng() % (N + 3);
+        size_t amt, off;
+        T *win;
+        switch (rng() % 8) {
+        case 0:
+        case 1:
+        case 2: // push
+            for (size_t i = 0; i < len; i++) { data[i] = (T)(next++ & mask); }
+            amt = rb.push(data, len);
+            CHECK(amt == std::min(len, N - models[BlockingReader].size()));
+            for (uint32_t r = 0; r < 2; r++) { models[r].insert(models[r].end(), data, data + amt); }
+            if (models[DroppingReader].size() > N) {
+                size_t over = models[DroppingReader].size() - N;
+                models[DroppingReader].erase(models[DroppingReader].begin(), models[DroppingReader].begin() + over);
+                drops[DroppingReader] += over;
+            }
+            break;
+        case 3: // pop
+            amt = rb.pop(reader, data, len);
+            CHECK(amt == std::min(len, m.size()));
+            for (size_t i = 0; i < amt; i++) {
+                CHECK(data[i] == (T)m.front());
+                m.pop_front();
+            }
+            break;
+        case 4: // seek
+            amt = rb.seek(reader, len);
+            CHECK(amt == std::min(len, m.size()));
+            m.erase(m.begin(), m.begin() + amt);
+            break;
+        case 5: // flush (rarely, so the blocking reader spends time near full)
+            if (rng() % 8 == 0) {
+                CHECK(rb.flush(reader) == m.size());
+                m.clear();
+            }
+            break;
+        case 6: // view
+            if constexpr (V > 0) {
+                len = rng() % (V + 2);
+                win = rb.view(reader, len);
+                CHECK((win != nullptr) == (len <= V && len <= m.size()));
+                for (size_t i = 0; win && i < len; i++) { CHECK(win[i] == (T)m[i]); }
+            }
+            break;
+        default: // peek_at
+            off = rng() % (m.size() + 2);
+            amt = rb.peek_at(reader, off, data, len);
+            CHECK(amt == (off < m.size() ? std::min(len, m.size() - off) : 0));
+            for (size_t i = 0; i < amt; i++) { CHECK(data[i] == (T)m[off + i]); }
+            break;
+        }
+        check_broadcast_ring(rb, models, drops);
+    }
+}
+
+void
+test_broadcast_rings(uint32_t seed, uint32_t ops) {
+    switch (seed % 4) {
+    case 0: test_broadcast_ring<uint8_t, 2, 0>(seed, ops); break;
+    case 1: test_broadcast_ring<uint16_t, 16, 0>(seed, ops); break;
+    case 2: test_broadcast_ring<uint32_t, 8, 3>(seed, ops); break;
+    default: test_broadcast_ring<uint16_t, 32, 32>(seed, ops); break;
+    }
+}
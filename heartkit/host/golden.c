@@ -0,0 +1,132 @@
+/**
+ * @file golden.c
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Golden output record/check for host replay (host build only)
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "golden.h"
+
+static uint32_t
+golden_load(golden_context_t *ctx, FILE *fp) {
+    char line[128];
+    int den;
+    unsigned int mask, label;
+    float hr, hrv;
+    uint32_t frameCap = 0, metricCap = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (sscanf(line, "F %d %u", &den, &mask) == 2) {
+            if (ctx->numGoldFrames == frameCap) {
+                frameCap = frameCap ? 2 * frameCap : 4096;
+                ctx->den = (int16_t *)realloc(ctx->den, frameCap * sizeof(int16_t));
+                ctx->mask = (uint16_t *)realloc(ctx->mask, frameCap * sizeof(uint16_t));
+                if (ctx->den == NULL || ctx->mask == NULL) { return 1; }
+            }
+            ctx->den[ctx->numGoldFrames] = (int16_t)den;
+            ctx->mask[ctx->numGoldFrames] = (uint16_t)mask;
+            ctx->numGoldFrames++;
+        } else if (sscanf(line, "M %f %f %u", &hr, &hrv, &label) == 3) {
+            if (ctx->numGoldMetrics == metricCap) {
+                metricCap = metricCap ? 2 * metricCap : 256;
+                ctx->hr = (float *)realloc(ctx->hr, metricCap * sizeof(float));
+                ctx->hrv = (float *)realloc(ctx->hrv, metricCap * sizeof(float));
+                ctx->label = (uint32_t *)realloc(ctx->label, metricCap * sizeof(uint32_t));
+                if (ctx->hr == NULL || ctx->hrv == NULL || ctx->label == NULL) { return 1; }
+            }
+            ctx->hr[ctx->numGoldMetrics] = hr;
+            ctx->hrv[ctx->numGoldMetrics] = hrv;
+            ctx->label[ctx->numGoldMetrics] = label;
+            ctx->numGoldMetrics++;
+        } else if (line[0] != '#') {
+            return 1;
+        }
+    }
+    return ctx->numGoldFrames == 0;
+}
+
+uint32_t
+golden_open(golden_context_t *ctx, const char *path, uint32_t check, const char *header) {
+    FILE *fp;
+    uint32_t err;
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->check = check;
+    if (!check) {
+        ctx->fp = fopen(path, "w");
+        if (ctx->fp == NULL) { return 1; }
+        fprintf(ctx->fp, "# %s\n", header);
+        return 0;
+    }
+    fp = fopen(path, "r");
+    if (fp == NULL) { return 1; }
+    err = golden_load(ctx, fp);
+    fclose(fp);
+    return err;
+}
+
+void
+golden_frame(golden_context_t *ctx, int16_t den, uint16_t mask) {
+    uint32_t err, i = ctx->numFrames++;
+    if (ctx->fp != NULL) {
+        fprintf(ctx->fp, "F %d %u\n", den, mask);
+    }
+    if (!ctx->check || i >= ctx->numGoldFrames) { return; }
+    err = abs(den - ctx->den[i]);
+    ctx->denMaxErr = err > ctx->denMaxErr ? err : ctx->denMaxErr;
+    ctx->denSqErr += (double)err * err;
+    ctx->maskDiffs += mask != ctx->mask[i];
+}
+
+void
+golden_metrics(golden_context_t *ctx, float hr, float hrv, uint32_t label) {
+    uint32_t i = ctx->numMetrics++;
+    if (ctx->fp != NULL) {
+        fprintf(ctx->fp, "M %.3f %.3f %u\n", hr, hrv, label);
+    }
+    if (!ctx->check || i >= ctx->numGoldMetrics) { return; }
+    ctx->hrMaxErr = fmaxf(ctx->hrMaxErr, fabsf(hr - ctx->hr[i]));
+    ctx->hrvMaxErr = fmaxf(ctx->hrvMaxErr, fabsf(hrv - ctx->hrv[i]));
+    ctx->labelDiffs += label != ctx->label[i];
+}
+
+uint32_t
+golden_close(golden_context_t *ctx) {
+    uint32_t numFrames, fail = 0;
+    float maskPct;
+    if (ctx->fp != NULL) {
+        fclose(ctx->fp);
+        ctx->fp = NULL;
+    }
+    if (!ctx->check) { return 0; }
+    // Only the overlap is compared- a length change is a failure of its own
+    numFrames = ctx->numFrames < ctx->numGoldFrames ? ctx->numFrames : ctx->numGoldFrames;
+    maskPct = numFrames ? 100.0f * ctx->maskDiffs / numFrames : 0;
+    fail |= ctx->numFrames != ctx->numGoldFrames || ctx->numMetrics != ctx->numGoldMetrics;
+    fail |= ctx->denMaxErr > GOLDEN_DEN_TOL;
+    fail |= maskPct > GOLDEN_MASK_TOL_PCT;
+    fail |= ctx->hrMaxErr > GOLDEN_HR_TOL || ctx->hrvMaxErr > GOLDEN_HRV_TOL;
+    fail |= ctx->labelDiffs > GOLDEN_LABEL_TOL;
+    printf("%-14s %10s %10s %10s\n", "golden", "current", "golden", "error");
+    printf("%-14s %10u %10u %10s\n", "frames", ctx->numFrames, ctx->numGoldFrames, "");
+    printf("%-14s %10u %10u %10s\n", "metrics", ctx->numMetrics, ctx->numGoldMetrics, "");
+    printf("%-14s %10s %10s %10u (rms %.1f, tol %d)\n", "den", "", "", ctx->denMaxErr,
+        numFrames ? sqrt(ctx->denSqErr / numFrames) : 0.0, GOLDEN_DEN_TOL);
+    printf("%-14s %10s %10s %9.2f%% (tol %.2f%%)\n", "mask", "", "", maskPct, GOLDEN_MASK_TOL_PCT);
+    printf("%-14s %10s %10s %10.2f (tol %.2f)\n", "hr", "", "", ctx->hrMaxErr, GOLDEN_HR_TOL);
+    printf("%-14s %10s %10s %10.2f (tol %.2f)\n", "hrv", "", "", ctx->hrvMaxErr, GOLDEN_HRV_TOL);
+    printf("%-14s %10s %10s %10u (tol %d)\n", "label", "", "", ctx->labelDiffs, GOLDEN_LABEL_TOL);
+    printf("golden check %s\n", fail ? "FAILED" : "passed");
+    free(ctx->den);
+    free(ctx->mask);
+    free(ctx->hr);
+    free(ctx->hrv);
+    free(ctx->label);
+    return fail;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file golden.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Golden output record/check for host replay (host build only)
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __HOST_GOLDEN_H
+#define __HOST_GOLDEN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Check tolerances (golden vs current)
+#define GOLDEN_DEN_TOL (50) // Max abs error of denoised ECG (q15 at ECG_Q15_SCALE)
+#define GOLDEN_MASK_TOL_PCT (1.0) // Max % of mask values that differ
+#define GOLDEN_HR_TOL (1.0) // Max abs error of HR (bpm)
+#define GOLDEN_HRV_TOL (5.0) // Max abs error of HRV (ms)
+#define GOLDEN_LABEL_TOL (0) // Max arrhythmia labels that differ
+
+/**
+ * @brief Golden output context
+ * Record mode writes one line per Tx frame ("F den mask") and per metrics
+ * run ("M hr hrv label"). Check mode loads a recorded file and compares
+ * frames and metrics runs in order against it.
+ *
+ */
+typedef struct {
+    FILE *fp;       // Record file (record mode)
+    uint32_t check; // 1: check against golden, 0: record
+    // Golden (check mode)
+    int16_t *den;
+    uint16_t *mask;
+    float *hr;
+    float *hrv;
+    uint32_t *label;
+    uint32_t numGoldFrames;
+    uint32_t numGoldMetrics;
+    // State
+    uint32_t numFrames;
+    uint32_t numMetrics;
+    uint32_t denMaxErr;
+    double denSqErr;
+    uint32_t maskDiffs;
+    float hrMaxErr;
+    float hrvMaxErr;
+    uint32_t labelDiffs;
+} golden_context_t;
+
+/**
+ * @brief Open golden file for record or check
+ *
+ * @param ctx Golden context
+ * @param path Golden file
+ * @param check 1 to check against file, 0 to record
+ * @param header Comment written as first line (record mode)
+ * @return uint32_t 0 on success
+ */
+uint32_t
+golden_open(golden_context_t *ctx, const char *path, uint32_t check, const char *header);
+
+/**
+ * @brief Record or check one Tx frame (no-op when not open)
+ *
+ * @param ctx Golden context
+ * @param den Denoised ECG (q15)
+ * @param mask Segmentation mask
+ */
+void
+golden_frame(golden_context_t *ctx, int16_t den, uint16_t mask);
+
+/**
+ * @brief Record or check one metrics run (no-op when not open)
+ *
+ * @param ctx Golden context
+ * @param hr Heart rate (bpm)
+ * @param hrv Heart rate variability (ms)
+ * @param label Arrhythmia label
+ */
+void
+golden_metrics(golden_context_t *ctx, float hr, float hrv, uint32_t label);
+
+/**
+ * @brief Close file and report (check mode)
+ *
+ * @param ctx Golden context
+ * @return uint32_t 0 if within tolerance (or record mode), 1 otherwise
+ */
+uint32_t
+golden_close(golden_context_t *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_GOLDEN_H
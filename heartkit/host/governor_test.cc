@@ -0,0 +1,112 @@
+/**
+ * @file governor_test.cc
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host tests for the stage quality governor
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Drives governor_update() with synthetic backlogs and feeds UIO mode
+ * records through governor_request_mode() as the stage task does: step
+ * down, drain, floor, restore, the cap at the requested mode, and a UIO
+ * record echoing a governed mode back while the stage is stepped down.
+ *
+ *   make -f make/host.mk governor-test
+ *
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "governor.h"
+
+#define CHECK(cond)                                                        \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                       \
+        }                                                                  \
+    } while (0)
+
+#define TEST_DEGRADE_BACKLOG (2)
+#define TEST_RESTORE_RUNS (3)
+
+static governor_stage_t
+make_governor(uint8_t minMode, uint8_t mode) {
+    governor_stage_t gov = {
+        .minMode = minMode,
+        .degradeBacklog = TEST_DEGRADE_BACKLOG,
+        .degradeUs = 1000,
+        .restoreRuns = TEST_RESTORE_RUNS,
+    };
+    governor_set_mode(&gov, mode);
+    return gov;
+}
+
+static void
+run_caught_up(governor_stage_t *gov, uint32_t runs) {
+    for (uint32_t i = 0; i < runs; i++) {
+        governor_update(gov, 0, 10);
+    }
+}
+
+static void
+test_step_down_and_restore() {
+    governor_stage_t gov = make_governor(0, 2);
+    CHECK(governor_update(&gov, TEST_DEGRADE_BACKLOG, 10) == 1 && gov.mode == 1);
+    // Draining backlog gets a chance to catch up
+    CHECK(governor_update(&gov, TEST_DEGRADE_BACKLOG, 10) == 1 && gov.mode == 0);
+    CHECK(governor_update(&gov, TEST_DEGRADE_BACKLOG + 1, 10) == 0 && gov.mode == 0);
+    CHECK(governor_update(&gov, 1, 10) == 0 && gov.mode == 0);
+    CHECK(governor_update(&gov, 0, 2000) == 0 && gov.mode == 0);
+    run_caught_up(&gov, TEST_RESTORE_RUNS);
+    CHECK(gov.mode == 1);
+    run_caught_up(&gov, TEST_RESTORE_RUNS);
+    CHECK(gov.mode == 2);
+    run_caught_up(&gov, 4 * TEST_RESTORE_RUNS);
+    CHECK(gov.mode == 2 && gov.requestedMode == 2);
+}
+
+static void
+test_floor() {
+    governor_stage_t gov = make_governor(1, 2);
+    CHECK(governor_update(&gov, 0, 2000) == 1 && gov.mode == 1);
+    CHECK(governor_update(&gov, 0, 2000) == 0 && gov.mode == 1);
+}
+
+static void
+test_echo_after_step_down() {
+    governor_stage_t gov = make_governor(0, 2);
+    CHECK(governor_update(&gov, 0, 2000) == 1 && gov.mode == 1);
+    // Dashboard echoes the whole UIO record (with the governed mode) after an unrelated change
+    CHECK(governor_request_mode(&gov, 1) == 0);
+    CHECK(gov.requestedMode == 2 && gov.mode == 1);
+    run_caught_up(&gov, TEST_RESTORE_RUNS);
+    CHECK(gov.mode == 2);
+}
+
+static void
+test_requests() {
+    governor_stage_t gov = make_governor(0, 2);
+    // Matching the requested mode is a no-op
+    CHECK(governor_request_mode(&gov, 2) == 0);
+    // Lowering below an ungoverned mode is a real request
+    CHECK(governor_request_mode(&gov, 1) == 1 && gov.requestedMode == 1 && gov.mode == 1);
+    run_caught_up(&gov, 2 * TEST_RESTORE_RUNS);
+    CHECK(gov.mode == 1);
+    // Any other mode while stepped down is a real request too
+    CHECK(governor_request_mode(&gov, 2) == 1);
+    CHECK(governor_update(&gov, 0, 2000) == 1 && gov.mode == 1);
+    CHECK(governor_request_mode(&gov, 0) == 1 && gov.requestedMode == 0 && gov.mode == 0);
+    run_caught_up(&gov, 2 * TEST_RESTORE_RUNS);
+    CHECK(gov.mode == 0);
+}
+
+int main(int argc, char *argv[]) {
+    test_step_down_and_restore();
+    test_floor();
+    test_echo_after_step_down();
+    test_requests();
+    printf("governor: all tests passed\n");
+    return 0;
+}
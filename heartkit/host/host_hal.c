@@ -0,0 +1,162 @@
+/**
+ * @file host_hal.c
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host stand-in for neuralSPOT, board and Tileio (host build only)
+ * Peripherals are no-ops and the us ticker reads the monotonic clock.
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "ns_ambiqsuite_harness.h"
+#include "ns_i2c.h"
+#include "ns_peripherals_button.h"
+#include "ns_peripherals_power.h"
+#include "ns_max86150_driver.h"
+#include "am_devices_led.h"
+#include "tileio.h"
+
+const ns_core_api_t ns_core_V1_0_0 = {.version = 1};
+const ns_core_api_t ns_power_V1_0_0 = {.version = 1};
+const ns_core_api_t ns_timer_V1_0_0 = {.version = 1};
+const ns_core_api_t ns_i2c_V1_0_0 = {.version = 1};
+const ns_core_api_t ns_button_V1_0_0 = {.version = 1};
+
+bool host_verbose = false;
+
+///////////////////////////////////////////////////////////////////////////////
+// Harness
+///////////////////////////////////////////////////////////////////////////////
+
+int
+ns_lp_printf(const char *fmt, ...) {
+    int ret;
+    va_list args;
+    if (!host_verbose) { return 0; }
+    va_start(args, fmt);
+    ret = vprintf(fmt, args);
+    va_end(args);
+    return ret;
+}
+
+void ns_itm_printf_enable(void) {}
+
+void ns_interrupt_master_enable(void) {}
+
+void
+ns_core_fail_loop(void) {
+    // NS_TRY message is only shown with host_verbose
+    fprintf(stderr, "Init failed\n");
+    exit(EXIT_FAILURE);
+}
+
+void ns_delay_us(uint32_t us) {}
+
+uint32_t ns_core_init(ns_core_config_t *cfg) { return 0; }
+
+uint32_t ns_power_config(const ns_power_config_t *cfg) { return 0; }
+
+void ns_set_performance_mode(ns_power_mode_e mode) {}
+
+uint32_t ns_peripheral_button_init(ns_button_config_t *cfg) { return 0; }
+
+///////////////////////////////////////////////////////////////////////////////
+// Timers
+///////////////////////////////////////////////////////////////////////////////
+
+// Clear point of each timer (us)
+static uint64_t timerBaseUs[NS_TIMER_TEMPCO + 1];
+
+static uint64_t
+host_monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint32_t
+ns_timer_init(ns_timer_config_t *cfg) {
+    timerBaseUs[cfg->timer] = host_monotonic_us();
+    return 0;
+}
+
+uint32_t
+ns_us_ticker_read(ns_timer_config_t *cfg) {
+    return (uint32_t)(host_monotonic_us() - timerBaseUs[cfg->timer]);
+}
+
+uint32_t
+ns_timer_clear(ns_timer_config_t *cfg) {
+    timerBaseUs[cfg->timer] = host_monotonic_us();
+    return 0;
+}
+
+// Scheduler never runs on host (no task is ever current)
+void * volatile pxCurrentTCB = NULL;
+
+///////////////////////////////////////////////////////////////////////////////
+// I2C, sensor and LEDs
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t ns_i2c_interface_init(ns_i2c_config_t *cfg, uint32_t speed) { return 0; }
+
+int32_t
+ns_i2c_write_read(ns_i2c_config_t *cfg, uint16_t addr, const void *writeBuf, size_t numWrite, void *readBuf, size_t numRead) {
+    return 1;
+}
+
+int32_t ns_i2c_read(ns_i2c_config_t *cfg, const void *buf, uint32_t numBytes, uint16_t addr) { return 1; }
+
+int32_t ns_i2c_write(ns_i2c_config_t *cfg, const void *buf, uint32_t numBytes, uint16_t addr) { return 1; }
+
+void max86150_set_prox_int_flag(const max86150_context_t *ctx, uint8_t enable) {}
+void max86150_set_fifo_slots(const max86150_context_t *ctx, max86150_slot_type *slots) {}
+void max86150_set_almost_full_rollover(const max86150_context_t *ctx, uint8_t enable) {}
+void max86150_set_fifo_enable(const max86150_context_t *ctx, uint8_t enable) {}
+void max86150_powerup(const max86150_context_t *ctx) {}
+void max86150_shutdown(const max86150_context_t *ctx) {}
+void max86150_reset(const max86150_context_t *ctx) {}
+void max86150_set_ppg_adc_range(const max86150_context_t *ctx, uint8_t range) {}
+void max86150_set_ppg_sample_rate(const max86150_context_t *ctx, uint8_t value) {}
+void max86150_set_ppg_pulse_width(const max86150_context_t *ctx, uint8_t value) {}
+void max86150_set_ppg_sample_average(const max86150_context_t *ctx, uint8_t value) {}
+void max86150_set_led_pulse_amplitude(const max86150_context_t *ctx, uint8_t led, uint8_t value) {}
+void max86150_set_led_current_range(const max86150_context_t *ctx, uint8_t led, uint8_t value) {}
+void max86150_set_ecg_sample_rate(const max86150_context_t *ctx, uint8_t value) {}
+void max86150_set_ecg_pga_gain(const max86150_context_t *ctx, uint8_t value) {}
+void max86150_set_ecg_ia_gain(const max86150_context_t *ctx, uint8_t value) {}
+
+uint8_t max86150_get_part_id(const max86150_context_t *ctx) { return 0; }
+
+uint32_t
+max86150_read_fifo_samples(const max86150_context_t *ctx, uint32_t *buffer, max86150_slot_type *slots, uint8_t numSlots) {
+    return 0;
+}
+
+void am_devices_led_array_init(am_devices_led_t *psLEDs, uint32_t ui32NumLEDs) {}
+
+void am_devices_led_array_out(am_devices_led_t *psLEDs, uint32_t ui32NumLEDs, uint32_t ui32Value) {}
+
+bool am_devices_led_get(am_devices_led_t *psLEDs, uint32_t ui32LEDNum) { return false; }
+
+///////////////////////////////////////////////////////////////////////////////
+// Tileio
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t tio_init(tio_context_t *ctx) { return 0; }
+
+void tio_start(tio_context_t *ctx) {}
+
+void tio_send_slot_data(uint8_t slot, uint8_t slot_type, const uint8_t *data, uint32_t length) {}
+
+void tio_send_uio_state(const uint8_t *data, uint32_t length) {}
+
+void TioTask(void *pvParameters) {}
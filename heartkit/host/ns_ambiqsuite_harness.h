@@ -0,0 +1,49 @@
+/**
+ * @file ns_ambiqsuite_harness.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host stand-in for neuralSPOT harness (host build only)
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __HOST_NS_AMBIQSUITE_HARNESS_H
+#define __HOST_NS_AMBIQSUITE_HARNESS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    uint32_t version;
+} ns_core_api_t;
+
+// Board LEDs (am_devices_led_t) are not backed by anything on host
+#define AM_BSP_NUM_LEDS (3)
+#define am_bsp_psLEDs ((am_devices_led_t *)0)
+
+// App logging (ns_lp_printf) is dropped unless set
+extern bool host_verbose;
+
+int ns_lp_printf(const char *fmt, ...);
+void ns_itm_printf_enable(void);
+void ns_interrupt_master_enable(void);
+void ns_core_fail_loop(void);
+void ns_delay_us(uint32_t us);
+
+#define NS_TRY(func, msg)                                                                          \
+    if (func) {                                                                                    \
+        ns_lp_printf(msg);                                                                         \
+        ns_core_fail_loop();                                                                       \
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_NS_AMBIQSUITE_HARNESS_H
@@ -0,0 +1,18 @@
+/**
+ * @file ns_ble.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host stand-in for neuralSPOT BLE (host build only)
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __HOST_NS_BLE_H
+#define __HOST_NS_BLE_H
+
+#include "ns_peripherals_power.h"
+
+#define NS_BLE_DEFAULT_MALLOC_K (8)
+
+#endif // __HOST_NS_BLE_H
@@ -0,0 +1,36 @@
+/**
+ * @file ns_i2c.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host stand-in for neuralSPOT I2C (host build only)
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __HOST_NS_I2C_H
+#define __HOST_NS_I2C_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ns_ambiqsuite_harness.h"
+
+extern const ns_core_api_t ns_i2c_V1_0_0;
+
+typedef struct {
+    const ns_core_api_t *api;
+    uint32_t iom;
+} ns_i2c_config_t;
+
+uint32_t ns_i2c_interface_init(ns_i2c_config_t *cfg, uint32_t speed);
+int32_t ns_i2c_write_read(ns_i2c_config_t *cfg, uint16_t addr, const void *writeBuf, size_t numWrite, void *readBuf, size_t numRead);
+int32_t ns_i2c_read(ns_i2c_config_t *cfg, const void *buf, uint32_t numBytes, uint16_t addr);
+int32_t ns_i2c_write(ns_i2c_config_t *cfg, const void *buf, uint32_t numBytes, uint16_t addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_NS_I2C_H
@@ -0,0 +1,36 @@
+/**
+ * @file ns_peripherals_button.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host stand-in for neuralSPOT buttons (host build only)
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __HOST_NS_PERIPHERALS_BUTTON_H
+#define __HOST_NS_PERIPHERALS_BUTTON_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ns_ambiqsuite_harness.h"
+
+extern const ns_core_api_t ns_button_V1_0_0;
+
+typedef struct {
+    const ns_core_api_t *api;
+    bool button_0_enable;
+    bool button_1_enable;
+    int volatile *button_0_flag;
+    int volatile *button_1_flag;
+} ns_button_config_t;
+
+uint32_t ns_peripheral_button_init(ns_button_config_t *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_NS_PERIPHERALS_BUTTON_H
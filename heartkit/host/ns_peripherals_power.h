@@ -0,0 +1,69 @@
+/**
+ * @file ns_peripherals_power.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host stand-in for neuralSPOT core, power and timers (host build only)
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __HOST_NS_PERIPHERALS_POWER_H
+#define __HOST_NS_PERIPHERALS_POWER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ns_ambiqsuite_harness.h"
+
+extern const ns_core_api_t ns_power_V1_0_0;
+extern const ns_core_api_t ns_core_V1_0_0;
+extern const ns_core_api_t ns_timer_V1_0_0;
+
+typedef enum { NS_MINIMUM_PERF, NS_MEDIUM_PERF, NS_MAXIMUM_PERF } ns_power_mode_e;
+
+typedef struct {
+    const ns_core_api_t *api;
+    ns_power_mode_e eAIPowerMode;
+    bool bNeedAudAdc;
+    bool bNeedSharedSRAM;
+    bool bNeedCrypto;
+    bool bNeedBluetooth;
+    bool bNeedUSB;
+    bool bNeedIOM;
+    bool bNeedAlternativeUART;
+    bool b128kTCM;
+    bool bEnableTempCo;
+    bool bNeedITM;
+} ns_power_config_t;
+
+typedef struct {
+    const ns_core_api_t *api;
+} ns_core_config_t;
+
+typedef enum { NS_TIMER_COUNTER, NS_TIMER_INTERRUPT, NS_TIMER_USB, NS_TIMER_TEMPCO } ns_timers_e;
+
+struct ns_timer_config;
+typedef void (*ns_timer_callback_cb)(struct ns_timer_config *);
+
+typedef struct ns_timer_config {
+    const ns_core_api_t *api;
+    ns_timers_e timer;
+    bool enableInterrupt;
+    uint32_t periodInMicroseconds;
+    ns_timer_callback_cb callback; // Never invoked on host
+} ns_timer_config_t;
+
+uint32_t ns_core_init(ns_core_config_t *cfg);
+uint32_t ns_power_config(const ns_power_config_t *cfg);
+void ns_set_performance_mode(ns_power_mode_e mode);
+uint32_t ns_timer_init(ns_timer_config_t *cfg);
+uint32_t ns_us_ticker_read(ns_timer_config_t *cfg);
+uint32_t ns_timer_clear(ns_timer_config_t *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_NS_PERIPHERALS_POWER_H
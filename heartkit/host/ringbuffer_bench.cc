@@ -0,0 +1,136 @@
+/**
+ * @file ringbuffer_bench.cc
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host benchmark for the ring buffers
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Prints ns/element for the common call patterns. Correctness is checked
+ * by ringbuffer_test; this only reports timings.
+ *
+ *   make -f make/host.mk ringbuffer-bench
+ *
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "ringbuffer.h"
+#include "typed_ringbuffer.h"
+
+static volatile uint32_t benchSink = 0;
+
+static double
+now_ns() {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief ns/element for rb_config_t round trips
+ *
+ * @param dlen Element size in bytes
+ * @param n Elements per call
+ */
+static void
+bench_c_ring(size_t dlen, size_t n) {
+    static uint8_t bufA[4 * 2001], bufB[4 * 2001], data[4 * 1000];
+    rb_config_t a = {.buffer = bufA, .dlen = dlen, .size = 2001, .head = 0, .tail = 0};
+    rb_config_t b = {.buffer = bufB, .dlen = dlen, .size = 2001, .head = 0, .tail = 0};
+    uint32_t iters = (uint32_t)(20000000 / n) + 1;
+    uint32_t sink = 0;
+    double t0, tPushSeek, tPushPop, tPeek, tTransfer;
+
+    memset(data, 0x5A, sizeof(data));
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        sink += ringbuffer_push(&a, data, n);
+        sink += ringbuffer_seek(&a, n);
+    }
+    tPushSeek = now_ns() - t0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        sink += ringbuffer_push(&a, data, n);
+        sink += ringbuffer_pop(&a, data, n);
+    }
+    tPushPop = now_ns() - t0;
+    ringbuffer_push(&a, data, n);
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        sink += ringbuffer_peek(&a, data, n);
+    }
+    tPeek = now_ns() - t0;
+    ringbuffer_flush(&a);
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        ringbuffer_push(&a, data, n);
+        sink += ringbuffer_transfer(&a, &b, n);
+        ringbuffer_seek(&b, n);
+    }
+    tTransfer = now_ns() - t0;
+    benchSink = sink;
+    printf("  %zuB    %-5zu %9.2f %9.2f %6.2f %9.2f\n", dlen, n, tPushSeek / iters / n, tPushPop / iters / n,
+           tPeek / iters / n, tTransfer / iters / n);
+}
+
+/**
+ * @brief ns/sample for 1-element round trips: rb_config_t vs RingBuffer
+ * push+peek+pop and the per-sample push+transfer+seek used by the pipeline.
+ */
+static void
+bench_typed_ring() {
+    static float bufA[2048], bufB[2048];
+    static RingBuffer<float, 2048> ta, tb;
+    rb_config_t ca = {.buffer = bufA, .dlen = sizeof(float), .size = 2048, .head = 0, .tail = 0};
+    rb_config_t cb = {.buffer = bufB, .dlen = sizeof(float), .size = 2048, .head = 0, .tail = 0};
+    const uint32_t iters = 20000000;
+    float val = 1.0f, out;
+    uint32_t sink = 0;
+    double t0, tC[2], tT[2];
+
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        sink += ringbuffer_push(&ca, &val, 1);
+        sink += ringbuffer_peek(&ca, &out, 1);
+        sink += ringbuffer_pop(&ca, &out, 1);
+    }
+    tC[0] = now_ns() - t0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        sink += ringbuffer_push(&ta, &val, 1);
+        sink += ringbuffer_peek(&ta, &out, 1);
+        sink += ringbuffer_pop(&ta, &out, 1);
+    }
+    tT[0] = now_ns() - t0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        sink += ringbuffer_push(&ca, &val, 1);
+        sink += ringbuffer_transfer(&ca, &cb, 1);
+        sink += ringbuffer_seek(&cb, 1);
+    }
+    tC[1] = now_ns() - t0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        sink += ringbuffer_push(&ta, &val, 1);
+        sink += ringbuffer_transfer(&ta, &tb, 1);
+        sink += ringbuffer_seek(&tb, 1);
+    }
+    tT[1] = now_ns() - t0;
+    benchSink = sink;
+    printf("\nfloat ns/sample, 1 element per call  rb_config_t  RingBuffer<float, 2048>\n");
+    printf("  push+peek+pop                      %9.2f  %9.2f\n", tC[0] / iters, tT[0] / iters);
+    printf("  push+transfer+seek                 %9.2f  %9.2f\n", tC[1] / iters, tT[1] / iters);
+}
+
+int main(int argc, char *argv[]) {
+    static const size_t dlens[] = {1, 2, 4};
+    static const size_t lens[] = {1, 16, 250, 1000};
+    printf("rb_config_t ns/element (size 2001; xfer is push+transfer+seek across two rings)\n");
+    printf("  size  n     push+seek  push+pop  peek       xfer\n");
+    for (size_t d : dlens) {
+        for (size_t n : lens) { bench_c_ring(d, n); }
+    }
+    bench_typed_ring();
+    return 0;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file ringbuffer_c_test.cc
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host property test for rb_config_t (ringbuffer.c)
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Randomized operation sequences are checked against a std::deque model:
+ * wraparound, full/empty, partial push/pop and transfer between rings of
+ * different sizes and element widths.
+ *
+ */
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include "ringbuffer.h"
+#include "ringbuffer_test.h"
+
+static void
+pack(uint8_t *dst, const uint32_t *src, size_t len, size_t dlen) {
+    for (size_t i = 0; i < len; i++) {
+        memcpy(dst + i * dlen, &src[i], dlen);
+    }
+}
+
+static uint32_t
+unpack(const uint8_t *src, size_t idx, size_t dlen) {
+    uint32_t val = 0;
+    memcpy(&val, src + idx * dlen, dlen);
+    return val;
+}
+
+static void
+check_c_ring(rb_config_t *rb, const model_t &model) {
+    uint8_t out[4 * 64];
+    CHECK(ringbuffer_len(rb) == model.size());
+    CHECK(ringbuffer_space(rb) == rb->size - 1 - model.size());
+    CHECK(ringbuffer_peek(rb, out, model.size()) == model.size());
+    for (size_t i = 0; i < model.size(); i++) {
+        CHECK(unpack(out, i, rb->dlen) == model[i]);
+    }
+}
+
+/**
+ * @brief Random push/fill/pop/peek/seek/flush/transfer against a deque model
+ *
+ * @param seed Random seed
+ * @param ops Number of operations
+ */
+void
+test_c_ring(uint32_t seed, uint32_t ops) {
+    std::mt19937 rng(seed);
+    static const size_t dlens[] = {1, 2, 4};
+    size_t dlen = dlens[rng() % 3];
+    uint32_t mask = elem_mask(dlen);
+    uint8_t bufA[4 * 42], bufB[4 * 42], data[4 * 64];
+    uint32_t vals[64];
+    rb_config_t a = {.buffer = bufA, .dlen = dlen, .size = 2 + (uint32_t)(rng() % 40), .head = 0, .tail = 0};
+    rb_config_t b = {.buffer = bufB, .dlen = dlen, .size = 2 + (uint32_t)(rng() % 40), .head = 0, .tail = 0};
+    model_t ma, mb;
+    uint32_t next = rng();
+
+    testSeed = seed;
+    for (testOp = 0; testOp < ops; testOp++) {
+        // Requests may exceed capacity to exercise the full/empty clamps
+        size_t len = rng() % (a.size + 3);
+        size_t amt;
+        switch (rng() % 8) {
+        case 0:
+        case 1: // push
+            for (size_t i = 0; i < len; i++) { vals[i] = next++ & mask; }
+            pack(data, vals, len, dlen);
+            amt = ringbuffer_push(&a, data, len);
+            CHECK(amt == std::min(len, a.size - 1 - ma.size()));
+            ma.insert(ma.end(), vals, vals + amt);
+            break;
+        case 2: // fill
+            vals[0] = next++ & mask;
+            pack(data, vals, 1, dlen);
+            amt = ringbuffer_fill(&a, data, len);
+            CHECK(amt == std::min(len, a.size - 1 - ma.size()));
+            ma.insert(ma.end(), amt, vals[0]);
+            break;
+        case 3: // pop
+            amt = ringbuffer_pop(&a, data, len);
+            CHECK(amt == std::min(len, ma.size()));
+            for (size_t i = 0; i < amt; i++) {
+                CHECK(unpack(data, i, dlen) == ma.front());
+                ma.pop_front();
+            }
+            break;
+        case 4: // seek
+            amt = ringbuffer_seek(&a, len);
+            CHECK(amt == std::min(len, ma.size()));
+            ma.erase(ma.begin(), ma.begin() + amt);
+            break;
+        case 5: // transfer a -> b, then drain some of b
+            amt = ringbuffer_transfer(&a, &b, len);
+            CHECK(amt == std::min(std::min(len, ma.size()), (size_t)(b.size - 1 - mb.size())));
+            mb.insert(mb.end(), ma.begin(), ma.begin() + amt);
+            ma.erase(ma.begin(), ma.begin() + amt);
+            amt = ringbuffer_pop(&b, data, rng() % (b.size + 1));
+            for (size_t i = 0; i < amt; i++) {
+                CHECK(unpack(data, i, dlen) == mb.front());
+                mb.pop_front();
+            }
+            check_c_ring(&b, mb);
+            break;
+        case 6: // flush (rarely, so rings spend time near full)
+            if (rng() % 8 == 0) {
+                CHECK(ringbuffer_flush(&a) == ma.size());
+                ma.clear();
+            }
+            break;
+        default: // peek
+            amt = ringbuffer_peek(&a, data, len);
+            CHECK(amt == std::min(len, ma.size()));
+            for (size_t i = 0; i < amt; i++) { CHECK(unpack(data, i, dlen) == ma[i]); }
+            break;
+        }
+        check_c_ring(&a, ma);
+    }
+}
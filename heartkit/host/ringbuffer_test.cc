@@ -0,0 +1,54 @@
+/**
+ * @file ringbuffer_test.cc
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host property tests for the ring buffers
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Runs each ring's randomized sequences against a std::deque model and
+ * exits non-zero on the first mismatch. Timings are in ringbuffer_bench.cc.
+ *
+ *   make -f make/host.mk ringbuffer-test
+ *   ./build-host/ringbuffer_test -s 60 -n 200000 -t 20000000
+ *
+ */
+#include <unistd.h>
+#include "ringbuffer_test.h"
+
+uint32_t testSeed = 0;
+uint32_t testOp = 0;
+
+static void
+print_usage(const char *prog) {
+    printf("Usage: %s [-s seeds] [-n ops] [-t count]\n", prog);
+    printf("  -s seeds  Random sequences per ring type (default 60)\n");
+    printf("  -n ops    Operations per sequence (default 200000)\n");
+    printf("  -t count  Sequence numbers exchanged by the SPSC threads (default 20000000)\n");
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t seeds = 60;
+    uint32_t ops = 200000;
+    uint32_t spscCount = 20000000;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:n:t:")) != -1) {
+        switch (opt) {
+        case 's': seeds = strtoul(optarg, NULL, 0); break;
+        case 'n': ops = strtoul(optarg, NULL, 0); break;
+        case 't': spscCount = strtoul(optarg, NULL, 0); break;
+        default: print_usage(argv[0]); return 1;
+        }
+    }
+
+    for (uint32_t s = 0; s < seeds; s++) { test_c_ring(s, ops); }
+    printf("rb_config_t: %u seeds x %u ops passed\n", seeds, ops);
+    for (uint32_t s = 0; s < seeds; s++) { test_typed_rings(s, ops); }
+    printf("RingBuffer: %u seeds x %u ops passed\n", seeds, ops);
+    for (uint32_t s = 0; s < seeds; s++) { test_broadcast_rings(s, ops); }
+    printf("BroadcastRingBuffer: %u seeds x %u ops passed\n", seeds, ops);
+    test_spsc_ring(seeds, spscCount);
+    printf("SPSC: %u sequence numbers passed\n", spscCount);
+    return 0;
+}
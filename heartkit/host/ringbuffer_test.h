@@ -0,0 +1,63 @@
+/**
+ * @file ringbuffer_test.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Shared checks and helpers for the host ring buffer tests
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __RINGBUFFER_TEST_H
+#define __RINGBUFFER_TEST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <deque>
+
+#define CHECK(cond)                                                                    \
+    do {                                                                               \
+        if (!(cond)) {                                                                 \
+            fprintf(stderr, "FAIL %s:%d: %s (seed %u op %u)\n", __FILE__, __LINE__, #cond, \
+                    testSeed, testOp);                                                 \
+            exit(1);                                                                   \
+        }                                                                              \
+    } while (0)
+
+// Sequence and operation under test, reported by CHECK
+extern uint32_t testSeed;
+extern uint32_t testOp;
+
+typedef std::deque<uint32_t> model_t;
+
+static inline uint32_t
+elem_mask(size_t dlen) {
+    return dlen >= 4 ? 0xFFFFFFFFu : (1u << (8 * dlen)) - 1;
+}
+
+/**
+ * @brief Random push/fill/pop/peek/seek/flush/transfer on rb_config_t (ringbuffer_c_test.cc)
+ */
+void
+test_c_ring(uint32_t seed, uint32_t ops);
+
+/**
+ * @brief Random sequences on RingBuffer<T, N, V> across types and sizes (typed_ringbuffer_test.cc)
+ */
+void
+test_typed_rings(uint32_t seed, uint32_t ops);
+
+/**
+ * @brief Producer and consumer threads exchange count sequence numbers (spsc_ringbuffer_test.cc)
+ */
+void
+test_spsc_ring(uint32_t seed, uint32_t count);
+
+/**
+ * @brief Random sequences on a blocking + droppable reader BroadcastRingBuffer (broadcast_ringbuffer_test.cc)
+ */
+void
+test_broadcast_rings(uint32_t seed, uint32_t ops);
+
+#endif // __RINGBUFFER_TEST_H
@@ -0,0 +1,31 @@
+/**
+ * @file semphr.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host stand-in for FreeRTOS semaphores (host build only)
+ * The host build is single threaded so take and give always succeed.
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __HOST_SEMPHR_H
+#define __HOST_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+typedef struct QueueDefinition *SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t
+xSemaphoreCreateBinary(void) {
+    static char sem;
+    return (SemaphoreHandle_t)&sem;
+}
+
+static inline BaseType_t
+xSemaphoreTake(SemaphoreHandle_t sem, TickType_t timeout) { return pdPASS; }
+
+static inline BaseType_t
+xSemaphoreGive(SemaphoreHandle_t sem) { return pdPASS; }
+
+#endif // __HOST_SEMPHR_H
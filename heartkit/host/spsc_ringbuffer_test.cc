@@ -0,0 +1,90 @@
+/**
+ * @file spsc_ringbuffer_test.cc
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host SPSC thread stress for RingBuffer (typed_ringbuffer.h)
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * A producer and a consumer thread exchange sequence numbers through one
+ * RingBuffer to exercise SPSC interleavings (see also ringbuffer-test-tsan).
+ *
+ */
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include "typed_ringbuffer.h"
+#include "ringbuffer_test.h"
+
+/**
+ * @brief Producer and consumer threads exchange count sequence numbers
+ * Both sides use random burst sizes and the producer occasionally yields so
+ * the ring runs both starved and full. The consumer mixes pop, view+seek,
+ * peek+seek and transfer into a local ring, and checks that every number
+ * arrives once and in order.
+ *
+ * @param seed Random seed
+ * @param count Sequence numbers to exchange
+ */
+void
+test_spsc_ring(uint32_t seed, uint32_t count) {
+    static RingBuffer<uint32_t, 256, 16> rb;
+    static RingBuffer<uint32_t, 64> local;
+    rb.flush();
+    local.flush();
+    testSeed = seed;
+    testOp = 0;
+
+    std::thread producer([seed, count]() {
+        std::mt19937 rng(seed ^ 0x9E3779B9u);
+        uint32_t data[64];
+        uint32_t next = 0;
+        while (next < count) {
+            size_t len = std::min<size_t>(1 + rng() % 64, count - next);
+            for (size_t i = 0; i < len; i++) { data[i] = next + i; }
+            next += rb.push(data, len);
+            if (rng() % 64 == 0) { std::this_thread::yield(); }
+        }
+    });
+
+    std::mt19937 rng(seed);
+    uint32_t data[64];
+    uint32_t expect = 0;
+    while (expect < count) {
+        size_t len = 1 + rng() % 64;
+        size_t amt = 0;
+        uint32_t *win;
+        switch (rng() % 4) {
+        case 0:
+            amt = rb.pop(data, len);
+            break;
+        case 1:
+            len = std::min<size_t>(len, 16);
+            win = rb.view(len);
+            if (win) {
+                memcpy(data, win, len * sizeof(uint32_t));
+                amt = rb.seek(len);
+                CHECK(amt == len);
+            }
+            break;
+        case 2:
+            amt = rb.peek(data, len);
+            CHECK(rb.seek(amt) == amt);
+            break;
+        default:
+            rb.transfer(local, len);
+            amt = local.pop(data, 64);
+            break;
+        }
+        for (size_t i = 0; i < amt; i++) {
+            testOp = expect;
+            CHECK(data[i] == expect);
+            expect++;
+        }
+        if (amt == 0) { std::this_thread::yield(); }
+    }
+    producer.join();
+    CHECK(rb.len() == 0 && local.len() == 0);
+}
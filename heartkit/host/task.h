@@ -0,0 +1,41 @@
+/**
+ * @file task.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host stand-in for FreeRTOS tasks (host build only)
+ * Tasks are never created so handles stay NULL and notifications and
+ * delays are no-ops.
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __HOST_TASK_H
+#define __HOST_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef struct tskTaskControlBlock *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+static inline BaseType_t
+xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stackLen, void *params, UBaseType_t priority, TaskHandle_t *handle) {
+    return pdFAIL;
+}
+
+static inline BaseType_t
+xTaskNotifyGive(TaskHandle_t task) { return pdPASS; }
+
+static inline uint32_t
+ulTaskNotifyTake(BaseType_t clear, TickType_t timeout) { return 0; }
+
+static inline void
+vTaskDelay(TickType_t ticks) {}
+
+static inline void
+vTaskSuspend(TaskHandle_t task) {}
+
+static inline void
+vTaskStartScheduler(void) {}
+
+#endif // __HOST_TASK_H
@@ -0,0 +1,149 @@
+/**
+ * @file typed_ringbuffer_test.cc
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Host property test for RingBuffer<T, N, V> (typed_ringbuffer.h)
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * Randomized operation sequences across element types, capacities and view
+ * lengths are checked against a std::deque model, including the
+ * pushed/dropped counters and the mirrored view.
+ *
+ */
+#include <algorithm>
+#include <random>
+#include "typed_ringbuffer.h"
+#include "ringbuffer_test.h"
+
+template <typename T, uint32_t N, uint32_t V>
+static void
+check_typed_ring(RingBuffer<T, N, V> &rb, const model_t &model) {
+    T out[N];
+    CHECK(rb.len() == model.size());
+    CHECK(rb.space() == N - model.size());
+    CHECK(rb.peek(out, N) == model.size());
+    for (size_t i = 0; i < model.size(); i++) {
+        CHECK(out[i] == (T)model[i]);
+    }
+}
+
+/**
+ * @brief Random push/fill/pop/peek/view/seek/flush/transfer against a deque model
+ * Also checks the pushed/dropped telemetry counters.
+ *
+ * @tparam T Element type
+ * @tparam N Capacity of ring under test
+ * @tparam M Capacity of transfer destination
+ * @tparam V View length
+ * @param seed Random seed
+ * @param ops Number of operations
+ */
+template <typename T, uint32_t N, uint32_t M, uint32_t V>
+static void
+test_typed_ring(uint32_t seed, uint32_t ops) {
+    static RingBuffer<T, N, V> a;
+    static RingBuffer<T, M> b;
+    std::mt19937 rng(seed);
+    uint32_t mask = elem_mask(sizeof(T));
+    T data[N + 3];
+    model_t ma, mb;
+    uint32_t next = rng();
+    uint32_t pushed = a.stats().pushed;
+    uint32_t dropped = a.stats().dropped;
+
+    // Rings are reused across seeds- start each sequence at a different offset
+    a.flush();
+    b.flush();
+    testSeed = seed;
+    for (testOp = 0; testOp < ops; testOp++) {
+        size_t len = rng() % (N + 3);
+        size_t amt, off;
+        T *win;
+        switch (rng() % 9) {
+        case 0:
+        case 1: // push
+            for (size_t i = 0; i < len; i++) { data[i] = (T)(next++ & mask); }
+            amt = ringbuffer_push(&a, data, len);
+            CHECK(amt == std::min(len, N - ma.size()));
+            ma.insert(ma.end(), data, data + amt);
+            pushed += amt;
+            dropped += len - amt;
+            CHECK(a.stats().pushed == pushed && a.stats().dropped == dropped);
+            break;
+        case 2: // fill
+            data[0] = (T)(next++ & mask);
+            amt = ringbuffer_fill(&a, &data[0], len);
+            CHECK(amt == std::min(len, N - ma.size()));
+            ma.insert(ma.end(), amt, data[0]);
+            pushed += amt;
+            dropped += len - amt;
+            break;
+        case 3: // pop
+            amt = ringbuffer_pop(&a, data, len);
+            CHECK(amt == std::min(len, ma.size()));
+            for (size_t i = 0; i < amt; i++) {
+                CHECK(data[i] == (T)ma.front());
+                ma.pop_front();
+            }
+            break;
+        case 4: // seek
+            amt = ringbuffer_seek(&a, len);
+            CHECK(amt == std::min(len, ma.size()));
+            ma.erase(ma.begin(), ma.begin() + amt);
+            break;
+        case 5: // transfer a -> b, then drain some of b
+            amt = ringbuffer_transfer(&a, &b, len);
+            CHECK(amt == std::min(std::min(len, ma.size()), (size_t)(M - mb.size())));
+            mb.insert(mb.end(), ma.begin(), ma.begin() + amt);
+            ma.erase(ma.begin(), ma.begin() + amt);
+            amt = ringbuffer_pop(&b, data, rng() % (std::min(M, N) + 1));
+            for (size_t i = 0; i < amt; i++) {
+                CHECK(data[i] == (T)mb.front());
+                mb.pop_front();
+            }
+            check_typed_ring(b, mb);
+            break;
+        case 6: // flush (rarely, so rings spend time near full)
+            if (rng() % 8 == 0) {
+                CHECK(ringbuffer_flush(&a) == ma.size());
+                ma.clear();
+            }
+            break;
+        case 7: // view
+            if constexpr (V > 0) {
+                len = rng() % (V + 2);
+                win = ringbuffer_view(&a, len);
+                CHECK((win != nullptr) == (len <= V && len <= ma.size()));
+                for (size_t i = 0; win && i < len; i++) { CHECK(win[i] == (T)ma[i]); }
+                off = rng() % (ma.size() + 2);
+                win = ringbuffer_view_at(&a, off, len);
+                CHECK((win != nullptr) == (len <= V && off + len <= ma.size()));
+                for (size_t i = 0; win && i < len; i++) { CHECK(win[i] == (T)ma[off + i]); }
+            }
+            break;
+        default: // peek
+            amt = ringbuffer_peek(&a, data, len);
+            CHECK(amt == std::min(len, ma.size()));
+            for (size_t i = 0; i < amt; i++) { CHECK(data[i] == (T)ma[i]); }
+            break;
+        }
+        check_typed_ring(a, ma);
+    }
+}
+
+/**
+ * @brief Run typed ring sequences across element types, sizes and views
+ */
+void
+test_typed_rings(uint32_t seed, uint32_t ops) {
+    switch (seed % 6) {
+    case 0: test_typed_ring<uint8_t, 2, 4, 0>(seed, ops); break;
+    case 1: test_typed_ring<uint16_t, 8, 32, 0>(seed, ops); break;
+    case 2: test_typed_ring<uint32_t, 32, 8, 0>(seed, ops); break;
+    case 3: test_typed_ring<uint8_t, 16, 16, 5>(seed, ops); break;
+    case 4: test_typed_ring<uint16_t, 32, 4, 32>(seed, ops); break;
+    default: test_typed_ring<uint32_t, 4, 64, 3>(seed, ops); break;
+    }
+}
@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+"""Generate the TFLM op resolver used by HeartKit models.
+
+Parses the flatbuffer arrays in the given model headers, collects the ops
+(and max op version) each model uses and writes a header that registers
+exactly those ops. Op enum names and resolver methods are read from the
+vendored TFLM headers so the output always matches the TFLM in the tree.
+
+Usage: gen_tflm_ops.py --tflm <tensorflow include dir> -o src/tflm_ops.h src/*_flatbuffer.h
+"""
+import argparse
+import os
+import re
+import struct
+import sys
+
+# Registered by the previous catch-all resolver (MicroMutableOpResolver<113>)
+ALL_OPS_COUNT = 113
+
+
+def read_flatbuffer(path):
+    """Return bytes of the first unsigned char array in a C header."""
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    body = text[text.index("{") + 1:text.index("}")]
+    return bytes(int(v, 0) for v in re.findall(r"0x[0-9a-fA-F]+|\d+", body))
+
+
+class Table:
+    """Minimal flatbuffer table reader."""
+
+    def __init__(self, buf, pos):
+        self.buf = buf
+        self.pos = pos
+        vtable = pos - struct.unpack_from("<i", buf, pos)[0]
+        vtsize = struct.unpack_from("<H", buf, vtable)[0]
+        self.fields = [
+            struct.unpack_from("<H", buf, vtable + 4 + 2 * i)[0] for i in range((vtsize - 4) // 2)
+        ]
+
+    def _field(self, idx):
+        if idx >= len(self.fields) or self.fields[idx] == 0:
+            return None
+        return self.pos + self.fields[idx]
+
+    def scalar(self, idx, fmt, default):
+        pos = self._field(idx)
+        return default if pos is None else struct.unpack_from(fmt, self.buf, pos)[0]
+
+    def _indirect(self, pos):
+        return pos + struct.unpack_from("<I", self.buf, pos)[0]
+
+    def string(self, idx):
+        pos = self._field(idx)
+        if pos is None:
+            return None
+        pos = self._indirect(pos)
+        length = struct.unpack_from("<I", self.buf, pos)[0]
+        return self.buf[pos + 4:pos + 4 + length].decode("utf-8")
+
+    def tables(self, idx):
+        pos = self._field(idx)
+        if pos is None:
+            return []
+        pos = self._indirect(pos)
+        length = struct.unpack_from("<I", self.buf, pos)[0]
+        return [Table(self.buf, self._indirect(pos + 4 + 4 * i)) for i in range(length)]
+
+
+def model_ops(buf):
+    """Return {(builtin code, custom name): max version} of a TFLite model."""
+    model = Table(buf, struct.unpack_from("<I", buf, 0)[0])
+    codes = model.tables(1)  # Model.operator_codes
+    used = set()
+    for subgraph in model.tables(2):  # Model.subgraphs
+        for op in subgraph.tables(3):  # SubGraph.operators
+            used.add(op.scalar(0, "<I", 0))  # Operator.opcode_index
+    ops = {}
+    for idx, code in enumerate(codes):
+        if idx not in used:
+            continue
+        # OperatorCode: deprecated_builtin_code (int8), custom_code, version, builtin_code
+        builtin = max(code.scalar(0, "<b", 0), code.scalar(3, "<i", 0))
+        key = (builtin, code.string(1))
+        ops[key] = max(ops.get(key, 0), code.scalar(2, "<i", 1))
+    return ops
+
+
+def resolver_methods(tflm_dir):
+    """Map builtin op names and custom op names to MicroMutableOpResolver methods."""
+    schema = os.path.join(tflm_dir, "tensorflow/lite/schema/schema_generated.h")
+    resolver = os.path.join(tflm_dir, "tensorflow/lite/micro/micro_mutable_op_resolver.h")
+    with open(schema, encoding="utf-8") as f:
+        enum = re.search(r"enum BuiltinOperator : int32_t \{(.*?)\};", f.read(), re.S).group(1)
+    names = {}
+    for name, code in re.findall(r"BuiltinOperator_(\w+) = (-?\d+)", enum):
+        if name not in ("MIN", "MAX"):
+            names[int(code)] = name
+    with open(resolver, encoding="utf-8") as f:
+        text = f.read()
+    builtins, customs = {}, {}
+    for method, body in re.findall(r"TfLiteStatus (Add\w+)\([^{]*\{(.*?)\n  \}", text, re.S):
+        if method in ("AddBuiltin", "AddCustom"):
+            continue
+        match = re.search(r"BuiltinOperator_(\w+)", body)
+        if match:
+            builtins.setdefault(match.group(1), method)
+            continue
+        match = re.search(r'AddCustom\("(\w+)"', body)
+        if match:
+            customs.setdefault(match.group(1), method)
+    return names, builtins, customs
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--tflm", required=True, help="TFLM include dir (contains tensorflow/)")
+    parser.add_argument("-o", "--output", required=True, help="Generated header")
+    parser.add_argument("models", nargs="+", help="Model flatbuffer headers")
+    args = parser.parse_args()
+
+    names, builtins, customs = resolver_methods(args.tflm)
+    ops = {}  # method -> (op name, max version, models)
+    for path in args.models:
+        model = os.path.splitext(os.path.basename(path))[0]
+        for (builtin, custom), version in model_ops(read_flatbuffer(path)).items():
+            name = custom if custom else names.get(builtin, str(builtin))
+            method = customs.get(custom) if custom else builtins.get(name)
+            if method is None:
+                sys.exit(f"{path}: no MicroMutableOpResolver method for op {name}")
+            _, maxVersion, models = ops.get(method, (name, 0, []))
+            ops[method] = (name, max(maxVersion, version), models + [model])
+
+    lines = [
+        "/**",
+        " * @file tflm_ops.h",
+        " * @brief TFLM ops used by HeartKit models",
+        " * Generated by make/gen_tflm_ops.py from:",
+    ]
+    lines += [f" *   {os.path.basename(p)}" for p in args.models]
+    lines += [
+        " * Do not edit- rebuild after changing a model.",
+        " *",
+        " */",
+        "#ifndef __HK_TFLM_OPS_H",
+        "#define __HK_TFLM_OPS_H",
+        "",
+        f"#define TFLM_NUM_OPS ({len(ops)})",
+        "",
+        "#ifdef __cplusplus",
+        "/**",
+        " * @brief Register model ops (op: max version used)",
+        " *",
+        " * @param resolver MicroMutableOpResolver with >= TFLM_NUM_OPS slots",
+        " * @return uint32_t 0 on success",
+        " */",
+        "template <typename OpResolver>",
+        "static inline uint32_t",
+        "tflm_add_ops(OpResolver &resolver) {",
+        "    uint32_t err = 0;",
+    ]
+    for method in sorted(ops):
+        name, version, models = ops[method]
+        lines.append(f"    err |= resolver.{method}() != kTfLiteOk; // {name}: v{version}")
+    lines += [
+        "    return err;",
+        "}",
+        "#endif",
+        "",
+        "#endif // __HK_TFLM_OPS_H",
+        "",
+    ]
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write("\n".join(lines))
+    print(f" TFLM resolver: {len(ops)} of {ALL_OPS_COUNT} ops ({', '.join(ops[m][0] for m in sorted(ops))})")
+
+
+if __name__ == "__main__":
+    main()
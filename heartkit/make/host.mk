@@ -0,0 +1,169 @@
+# Host (native Linux) build of the HeartKit pipeline
+#
+# Replays stimulus (or a record file) through the pipeline stages as fast as
+# possible and reports throughput per stage (see main() under HEARTKIT_HOST).
+# neuralSPOT, the HAL, FreeRTOS and Tileio are stubbed by host/. The
+# prebuilt libs are Cortex-M only so CMSIS-DSP and TFLM (reference kernels)
+# are built from source checkouts:
+#
+#   make -f make/host.mk CMSIS_DSP_DIR=<CMSIS_5>/CMSIS/DSP TFLM_DIR=<tflite-micro>
+#   ./build-host/heartkit -s 600 -d 2 -g 2 -a 2
+#
+# golden-record replays every input source at each GOLDEN_NOISE level and
+# saves outputs to GOLDEN_DIR. golden-check replays the same runs against
+# them and fails when any is out of tolerance (see host/golden.h).
+#
+# TFLM_DIR must be at the same commit as includes/extern/tensorflow.
+#
+# ringbuffer-test builds and runs the ring buffer property tests
+# (host/ringbuffer_*test.cc) and fails on the first mismatch. It needs
+# neither source checkout:
+#
+#   make -f make/host.mk ringbuffer-test RINGBUFFER_TEST_ARGS="-s 10"
+#
+# ringbuffer-test-tsan runs the same suite under ThreadSanitizer to check
+# the SPSC ordering of RingBuffer. ringbuffer-bench prints ns/element for
+# the common call patterns (host/ringbuffer_bench.cc).
+#
+# governor-test checks the stage quality governor (host/governor_test.cc).
+
+HOST_BINDIR ?= build-host
+HOST_CC ?= gcc
+HOST_CXX ?= g++
+CMSIS_DSP_DIR ?=
+TFLM_DIR ?=
+TF_VERSION := ce72f7b8_Feb_17_2024
+TFLM_INCLUDE := includes/extern/tensorflow/$(TF_VERSION)
+TFLM_LIB ?= $(TFLM_DIR)/tensorflow/lite/micro/tools/make/gen/linux_x86_64_default/lib/libtensorflow-microlite.a
+GOLDEN_DIR ?= $(HOST_BINDIR)/golden
+GOLDEN_INPUTS ?= 0 1 2 3 4 5 # NUM_INPUT_PTS
+GOLDEN_NOISE ?= 0,0,0 20,20,20 50,50,50
+GOLDEN_ARGS ?= -d 2 -g 2 -a 2
+RINGBUFFER_TEST_ARGS ?=
+
+ifneq "$(if $(MAKECMDGOALS),$(filter-out clean ringbuffer-test ringbuffer-test-tsan ringbuffer-bench governor-test,$(MAKECMDGOALS)),all)" ""
+ifeq ($(CMSIS_DSP_DIR),)
+$(error Set CMSIS_DSP_DIR to CMSIS-DSP sources (e.g. CMSIS_5/CMSIS/DSP))
+endif
+ifeq ($(TFLM_DIR),)
+$(error Set TFLM_DIR to tflite-micro sources)
+endif
+endif
+
+sources := $(addprefix src/,main.cc store.cc pipeline.c governor.c latency.c cpu_stats.c ringbuffer.c)
+sources += $(addprefix src/,metrics.cc nstdb_noise.c stimulus.c sensor.c)
+sources += $(addprefix src/,tflm.cc model_slot.c ecg_denoise.cc ecg_segmentation.cc ecg_arrhythmia.cc)
+sources += $(wildcard src/physiokit/*.c)
+sources += $(wildcard host/*.c)
+
+# One amalgamated source per CMSIS-DSP module
+dsp_sources := $(foreach d,$(wildcard $(CMSIS_DSP_DIR)/Source/*Functions $(CMSIS_DSP_DIR)/Source/CommonTables),$(wildcard $(d)/$(notdir $(d)).c))
+
+objects := $(addprefix $(HOST_BINDIR)/,$(addsuffix .o,$(basename $(sources))))
+dsp_objects := $(addprefix $(HOST_BINDIR)/cmsis-dsp/,$(addsuffix .o,$(basename $(notdir $(dsp_sources)))))
+test_sources := host/ringbuffer_test.cc host/ringbuffer_c_test.cc host/typed_ringbuffer_test.cc src/ringbuffer.c
+test_sources += host/spsc_ringbuffer_test.cc host/broadcast_ringbuffer_test.cc
+test_objects := $(addprefix $(HOST_BINDIR)/,$(addsuffix .o,$(basename $(test_sources))))
+tsan_objects := $(addprefix $(HOST_BINDIR)/tsan/,$(addsuffix .o,$(basename $(test_sources))))
+bench_objects := $(addprefix $(HOST_BINDIR)/,host/ringbuffer_bench.o src/ringbuffer.o)
+gov_test_objects := $(addprefix $(HOST_BINDIR)/,host/governor_test.o src/governor.o)
+dependencies := $(objects:.o=.d) $(dsp_objects:.o=.d) $(test_objects:.o=.d) $(tsan_objects:.o=.d) $(bench_objects:.o=.d) $(gov_test_objects:.o=.d)
+
+# __GNUC_PYTHON__ is CMSIS-DSP's plain GCC (non-Arm) configuration
+DEFINES := HEARTKIT_HOST TF_LITE_STATIC_MEMORY __GNUC_PYTHON__
+INCLUDES := host src src/physiokit
+INCLUDES += $(CMSIS_DSP_DIR)/Include $(CMSIS_DSP_DIR)/PrivateInclude
+INCLUDES += $(TFLM_INCLUDE) $(TFLM_INCLUDE)/third_party/flatbuffers/include
+INCLUDES += $(TFLM_INCLUDE)/third_party/gemmlowp $(TFLM_INCLUDE)/third_party/ruy
+
+CFLAGS := -O2 -g -Wall -MMD -MP $(addprefix -D,$(DEFINES)) $(addprefix -I,$(INCLUDES))
+CONLY_FLAGS := -std=c99
+CCFLAGS := -std=c++17 -fno-exceptions -fno-rtti
+LFLAGS := -lm -lpthread
+
+vpath %.c $(sort $(dir $(dsp_sources)))
+
+all: $(HOST_BINDIR)/heartkit
+
+$(HOST_BINDIR)/heartkit: $(objects) $(dsp_objects) $(TFLM_LIB)
+	@echo " Linking host $@"
+	$(HOST_CXX) -o $@ $(objects) $(dsp_objects) $(TFLM_LIB) $(LFLAGS)
+
+# Reference kernels via TFLM's own makefile
+$(TFLM_LIB):
+	@echo " Building TFLM microlite in $(TFLM_DIR)"
+	$(MAKE) -C $(TFLM_DIR) -f tensorflow/lite/micro/tools/make/Makefile microlite
+
+$(HOST_BINDIR)/cmsis-dsp/%.o: %.c
+	@echo " Compiling host $< to make $@"
+	@mkdir -p $(@D)
+	$(HOST_CC) -c $(CFLAGS) $(CONLY_FLAGS) $< -o $@
+
+TSAN_FLAGS := -O1 -fsanitize=thread
+
+$(HOST_BINDIR)/tsan/%.o: %.c
+	@echo " Compiling host (tsan) $< to make $@"
+	@mkdir -p $(@D)
+	$(HOST_CC) -c $(CFLAGS) $(CONLY_FLAGS) $(TSAN_FLAGS) $< -o $@
+
+$(HOST_BINDIR)/tsan/%.o: %.cc
+	@echo " Compiling host (tsan) $< to make $@"
+	@mkdir -p $(@D)
+	$(HOST_CXX) -c $(CFLAGS) $(CCFLAGS) $(TSAN_FLAGS) $< -o $@
+
+$(HOST_BINDIR)/%.o: %.c
+	@echo " Compiling host $< to make $@"
+	@mkdir -p $(@D)
+	$(HOST_CC) -c $(CFLAGS) $(CONLY_FLAGS) $< -o $@
+
+$(HOST_BINDIR)/%.o: %.cc
+	@echo " Compiling host $< to make $@"
+	@mkdir -p $(@D)
+	$(HOST_CXX) -c $(CFLAGS) $(CCFLAGS) $< -o $@
+
+golden-record: $(HOST_BINDIR)/heartkit
+	@mkdir -p $(GOLDEN_DIR)
+	@for i in $(GOLDEN_INPUTS); do for n in $(GOLDEN_NOISE); do \
+		echo " Recording golden input $$i noise $$n"; \
+		$(HOST_BINDIR)/heartkit -i $$i -n $$n $(GOLDEN_ARGS) -o $(GOLDEN_DIR)/input$$i-noise$$(echo $$n | tr , -).txt || exit 1; \
+	done; done
+
+golden-check: $(HOST_BINDIR)/heartkit
+	@fail=0; for i in $(GOLDEN_INPUTS); do for n in $(GOLDEN_NOISE); do \
+		echo " Checking golden input $$i noise $$n"; \
+		$(HOST_BINDIR)/heartkit -i $$i -n $$n $(GOLDEN_ARGS) -c $(GOLDEN_DIR)/input$$i-noise$$(echo $$n | tr , -).txt || fail=1; \
+	done; done; exit $$fail
+
+$(HOST_BINDIR)/ringbuffer_test: $(test_objects)
+	@echo " Linking host $@"
+	$(HOST_CXX) -o $@ $(test_objects) $(LFLAGS)
+
+ringbuffer-test: $(HOST_BINDIR)/ringbuffer_test
+	$(HOST_BINDIR)/ringbuffer_test $(RINGBUFFER_TEST_ARGS)
+
+$(HOST_BINDIR)/ringbuffer_test_tsan: $(tsan_objects)
+	@echo " Linking host (tsan) $@"
+	$(HOST_CXX) -fsanitize=thread -o $@ $(tsan_objects) $(LFLAGS)
+
+ringbuffer-test-tsan: $(HOST_BINDIR)/ringbuffer_test_tsan
+	$(HOST_BINDIR)/ringbuffer_test_tsan -s 6 -n 20000 -t 2000000
+
+$(HOST_BINDIR)/ringbuffer_bench: $(bench_objects)
+	@echo " Linking host $@"
+	$(HOST_CXX) -o $@ $(bench_objects) $(LFLAGS)
+
+ringbuffer-bench: $(HOST_BINDIR)/ringbuffer_bench
+	$(HOST_BINDIR)/ringbuffer_bench
+
+$(HOST_BINDIR)/governor_test: $(gov_test_objects)
+	@echo " Linking host $@"
+	$(HOST_CXX) -o $@ $(gov_test_objects) $(LFLAGS)
+
+governor-test: $(HOST_BINDIR)/governor_test
+	$(HOST_BINDIR)/governor_test
+
+.PHONY: all clean golden-record golden-check ringbuffer-test ringbuffer-test-tsan ringbuffer-bench governor-test
+clean:
+	rm -rf $(HOST_BINDIR)
+
+-include $(dependencies)
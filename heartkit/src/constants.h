@@ -33,7 +33,12 @@ extern "C" {
 #define SENSOR_RATE_MS (1000 / SENSOR_RATE)
 #define SENSOR_ECG_SLOT (0)
 #define SENSOR_BUF_LEN (4 * 64) // Double FIFO depth
+#define SENSOR_Q15_SHIFT (2) // 18-bit ADC stored as q15 (drop 2 LSBs)
+#define SENSOR_Q15_SCALE ((float32_t)(1 << SENSOR_Q15_SHIFT))
+#define STIMULUS_Q15_SCALE (1.0f) // 16-bit stimulus stored as q15 as is
 #define SENSOR_NOM_REFRESH_LEN (16)
+#define SENSOR_MIN_DELAY_MS (10) // One downsampled ECG sample
+#define SENSOR_MAX_DELAY_MS (80) // 16 samples (half of 32-deep FIFO at 200Hz)
 #define MAX86150_PART_ID_VAL (0x1E)
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -45,29 +50,49 @@ extern "C" {
 #define ECG_SOS_LEN (9)
 #define ECG_SAMPLE_RATE (100)
 #define ECG_DS_RATE (SENSOR_RATE / ECG_SAMPLE_RATE)
+#define ECG_Q15_SCALE (1.0f / TIO_SLOT0_SCALE) // Standardized ECG stored as q15 (+/-32.767)
+
+///////////////////////////////////////////////////////////////////////////////
+// TFLM Configuration
+///////////////////////////////////////////////////////////////////////////////
+
+// Activations of all models share one arena sized to the largest (denoise).
+// *_MODEL_SIZE_KB below only hold each model's persistent tensors.
+#define TFLM_SHARED_ARENA_SIZE_KB (60)
+// RAM slot for a model received over Tileio (fits denoise and segmentation,
+// only allocated with TFLM_MODEL_SLOT)
+#define TFLM_MODEL_SLOT_SIZE_KB (32)
 
 ///////////////////////////////////////////////////////////////////////////////
 // ECG Denoise Configuration
 ///////////////////////////////////////////////////////////////////////////////
 
-#define ECG_DEN_MODEL_SIZE_KB (63)
+#define ECG_DEN_MODEL_SIZE_KB (7)
 #define ECG_DEN_THRESHOLD (0.5) // 0.75
 #define ECG_DEN_WINDOW_LEN (250)
-#define ECG_DEN_PAD_LEN (25)
-#define ECG_DEN_VALID_LEN (ECG_DEN_WINDOW_LEN - 2 * ECG_DEN_PAD_LEN)
-#define ECG_DEN_BUF_LEN (2 * ECG_DEN_WINDOW_LEN)
+#define ECG_DEN_PAD_LEN (25) // Default pad (set over UIO)
+#define ECG_DEN_MAX_PAD_LEN (100) // Min hop of 50
+#define ECG_DEN_VALID_LEN (ECG_DEN_WINDOW_LEN - 2 * ECG_DEN_PAD_LEN) // Default hop
+#define ECG_DEN_MAX_HOP_LEN (ECG_DEN_WINDOW_LEN) // Pad of 0
+#define ECG_DEN_MAX_BATCH (4) // Windows per catch-up run
+#define ECG_DEN_BATCH_LEN (ECG_DEN_WINDOW_LEN + (ECG_DEN_MAX_BATCH - 1) * ECG_DEN_MAX_HOP_LEN)
+#define ECG_DEN_BUF_LEN (1024) // Power of 2 > ECG_DEN_BATCH_LEN
 
 ///////////////////////////////////////////////////////////////////////////////
 // ECG Segmentation Configuration
 ///////////////////////////////////////////////////////////////////////////////
 
-#define ECG_SEG_MODEL_SIZE_KB (27)
+#define ECG_SEG_MODEL_SIZE_KB (9)
 #define ECG_SEG_THRESHOLD (0.5) // 0.75
 #define ECG_SEG_NUM_CLASS (4) // 2
 #define ECG_SEG_WINDOW_LEN (250)
-#define ECG_SEG_PAD_LEN (25)
-#define ECG_SEG_VALID_LEN (ECG_SEG_WINDOW_LEN - 2 * ECG_SEG_PAD_LEN)
-#define ECG_SEG_BUF_LEN (2 * ECG_SEG_WINDOW_LEN)
+#define ECG_SEG_PAD_LEN (25) // Default pad (set over UIO)
+#define ECG_SEG_MAX_PAD_LEN (100) // Min hop of 50
+#define ECG_SEG_VALID_LEN (ECG_SEG_WINDOW_LEN - 2 * ECG_SEG_PAD_LEN) // Default hop
+#define ECG_SEG_MAX_HOP_LEN (ECG_SEG_WINDOW_LEN) // Pad of 0
+#define ECG_SEG_MAX_BATCH (4) // Windows per catch-up run
+#define ECG_SEG_BATCH_LEN (ECG_SEG_WINDOW_LEN + (ECG_SEG_MAX_BATCH - 1) * ECG_SEG_MAX_HOP_LEN)
+#define ECG_SEG_BUF_LEN (1024) // Power of 2 > ECG_SEG_BATCH_LEN
 
 // ECG Segmentation Classes
 #define ECG_SEG_NONE (0)
@@ -79,9 +104,10 @@ extern "C" {
 // ECG Arrhythmia Configuration
 ///////////////////////////////////////////////////////////////////////////////
 
-#define ECG_ARR_MODEL_SIZE_KB (22)
+#define ECG_ARR_MODEL_SIZE_KB (14)
 #define ECG_ARR_THRESHOLD (0.4)
 #define ECG_ARR_WINDOW_LEN (500)
+#define ECG_ARR_NUM_CLASS (4)
 #define ECG_ARR_PAD_LEN (0)
 #define ECG_ARR_VALID_LEN (ECG_ARR_WINDOW_LEN - 2 * ECG_ARR_PAD_LEN)
 #define ECG_ARR_BUF_LEN (2 * ECG_ARR_WINDOW_LEN)
@@ -105,6 +131,10 @@ extern "C" {
 #define TIO_UIO_DEN_MODE_IDX (5)
 #define TIO_UIO_SEG_MODE_IDX (6)
 #define TIO_UIO_ARR_MODE_IDX (7)
+#define TIO_UIO_DEN_PAD_IDX (8) // Samples
+#define TIO_UIO_SEG_PAD_IDX (9) // Samples
+#define TIO_UIO_MET_HOP_IDX (10) // x ECG_MET_HOP_UNIT_LEN
+#define TIO_UIO_LEN (16) // 8 byte records (older dashboards) leave pad/hop as is
 
 // TIO Mask Format
 // [5-0] : 6-bit segmentation
@@ -169,11 +199,20 @@ extern "C" {
 #define MAX_RR_PEAKS (100 * MET_CAPTURE_SEC)
 
 #define ECG_MET_WINDOW_LEN (MET_CAPTURE_SEC * ECG_SAMPLE_RATE)
-#define ECG_MET_PAD_LEN (8 * ECG_SAMPLE_RATE)
-#define ECG_MET_VALID_LEN (ECG_MET_WINDOW_LEN - ECG_MET_PAD_LEN)
-#define ECG_MET_BUF_LEN (2 * ECG_MET_WINDOW_LEN)
+#define ECG_MET_OVERLAP_LEN (8 * ECG_SAMPLE_RATE) // Default overlap (window - hop)
+#define ECG_MET_VALID_LEN (ECG_MET_WINDOW_LEN - ECG_MET_OVERLAP_LEN) // Default hop
+#define ECG_MET_HOP_UNIT_LEN (ECG_SAMPLE_RATE / 10) // UIO hop step (100 ms)
+#define ECG_MET_MIN_HOP_LEN (ECG_SAMPLE_RATE / 2)
+#define ECG_MET_BUF_LEN (2048) // Power of 2 >= 2 * ECG_MET_WINDOW_LEN (also TX backlog)
+
+///////////////////////////////////////////////////////////////////////////////
+// Governor Configuration
+///////////////////////////////////////////////////////////////////////////////
 
-#define ECG_TX_BUF_LEN ECG_SEG_BUF_LEN
+#define GOV_DEGRADE_BACKLOG (2) // Ready windows left after a run that step mode down
+#define GOV_RESTORE_RUNS (15) // Caught-up runs (~30 s) before stepping mode up
+#define GOV_LATENCY_PCT (75) // Run latency budget as % of hop period
+#define GOV_HOP_BUDGET_US(hop) ((hop) * (1000000 / ECG_SAMPLE_RATE) / 100 * GOV_LATENCY_PCT)
 
 ///////////////////////////////////////////////////////////////////////////////
 // Tileio Configuration
@@ -186,6 +225,37 @@ extern "C" {
 #define TIO_SLOT0_SIG_NUM_VALS (10)
 #define TIO_SLOT0_FS (ECG_SAMPLE_RATE / TIO_SLOT0_SIG_NUM_VALS)
 #define TIO_SLOT0_SCALE (1000)
+#define TIO_SLOT0_FRAMES_PER_PKT (40) // 240 byte payload / 6 byte frame
+#define TIO_SLOT0_TX_PERIOD_MS (100) // Signal send cadence- faster backs up Tileio
+
+#define TIO_RB_STATS_SLOT (3) // Ring buffer telemetry sent as slot3 metrics
+#define TIO_LATENCY_SLOT (2) // Latency percentiles sent as slot2 metrics
+#define TIO_CPU_STATS_SLOT (1) // Per-task CPU share sent as slot1 metrics
+#define TIO_OP_PROFILE_SLOT (3) // TFLM_PROFILE builds: per-op profile replaces ring stats
+#define TIO_OP_PROFILE_RECORDS_PER_PKT (30) // 240 byte payload / 8 byte record
+#define TIO_MODEL_SLOT (2) // Model transfer packets received as slot2 metrics (see model_slot.h)
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RTOS Task Configuration
+///////////////////////////////////////////////////////////////////////////////
+
+// Priorities follow deadline (configMAX_PRIORITIES = 4, 0 is idle). Prebuilt kernel
+// caps levels so den/seg share one- without time slicing a run is never preempted
+// by the other, and seg only has input once den blocks.
+#define TX_TASK_PRIORITY (3) // With Sensor and Tileio
+#define SEG_TASK_PRIORITY (2)
+#define DEN_TASK_PRIORITY (2)
+#define MET_TASK_PRIORITY (1)
+
+// Running task is sampled on timer2Cfg for per-task CPU share
+#define CPU_STATS_PERIOD_US (1000)
+
+// Stack depths in words- check with print_stack_watermarks() (<STACK> log)
+#define TX_TASK_STACK_LEN (512)
+#define SEG_TASK_STACK_LEN (1024)
+#define DEN_TASK_STACK_LEN (1024)
+#define MET_TASK_STACK_LEN (1024)
 
 
 ///////////////////////////////////////////////////////////////////////////////
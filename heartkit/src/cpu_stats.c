@@ -0,0 +1,51 @@
+/**
+ * @file cpu_stats.c
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Sampled per-task CPU accounting
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include "cpu_stats.h"
+
+void
+cpu_stats_register(cpu_stats_t *ctx, uint32_t idx, const void *task) {
+    __atomic_store_n(&ctx->tasks[idx], task, __ATOMIC_RELEASE);
+}
+
+void
+cpu_stats_register_idle(cpu_stats_t *ctx, const void *task) {
+    __atomic_store_n(&ctx->idleTask, task, __ATOMIC_RELEASE);
+}
+
+void
+cpu_stats_sample(cpu_stats_t *ctx, const void *task) {
+    uint32_t i;
+    if (task != NULL && __atomic_load_n(&ctx->idleTask, __ATOMIC_ACQUIRE) == task) {
+        i = ctx->numTasks + 1;
+    } else {
+        // Falls through to the other bucket (numTasks) when not registered
+        for (i = 0; i < ctx->numTasks; i++) {
+            if (task != NULL && __atomic_load_n(&ctx->tasks[i], __ATOMIC_ACQUIRE) == task) { break; }
+        }
+    }
+    __atomic_fetch_add(&ctx->counts[i], 1, __ATOMIC_RELAXED);
+}
+
+uint32_t
+cpu_stats_collect(cpu_stats_t *ctx, float *percents) {
+    uint32_t counts[CPU_STATS_MAX_TASKS + 2];
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < ctx->numTasks + 2; i++) {
+        counts[i] = __atomic_exchange_n(&ctx->counts[i], 0, __ATOMIC_RELAXED);
+        total += counts[i];
+    }
+    for (uint32_t i = 0; i < ctx->numTasks + 2; i++) {
+        percents[i] = total ? 100.0f * counts[i] / total : 0.0f;
+    }
+    return total;
+}
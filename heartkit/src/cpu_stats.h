@@ -0,0 +1,79 @@
+/**
+ * @file cpu_stats.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Sampled per-task CPU accounting
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __CPU_STATS_H
+#define __CPU_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define CPU_STATS_MAX_TASKS (8) // Registered tasks (+ other and idle buckets)
+
+/**
+ * @brief Per-task CPU accounting
+ * A periodic timer ISR records which task was running. Slots are the
+ * registered tasks, then "other" (unregistered tasks, e.g. timer service),
+ * then idle. Time spent in other ISRs is charged to the task they interrupted.
+ *
+ */
+typedef struct {
+    uint32_t numTasks;
+    const void *tasks[CPU_STATS_MAX_TASKS];
+    const void *idleTask;
+    // State
+    uint32_t counts[CPU_STATS_MAX_TASKS + 2];
+} cpu_stats_t;
+
+/**
+ * @brief Register task in slot idx
+ *
+ * @param ctx CPU stats
+ * @param idx Slot (< numTasks)
+ * @param task Task handle
+ */
+void
+cpu_stats_register(cpu_stats_t *ctx, uint32_t idx, const void *task);
+
+/**
+ * @brief Register idle task (counted in slot numTasks + 1)
+ *
+ * @param ctx CPU stats
+ * @param task Idle task handle
+ */
+void
+cpu_stats_register_idle(cpu_stats_t *ctx, const void *task);
+
+/**
+ * @brief Record running task (ISR)
+ *
+ * @param ctx CPU stats
+ * @param task Running task handle
+ */
+void
+cpu_stats_sample(cpu_stats_t *ctx, const void *task);
+
+/**
+ * @brief Get share of samples per slot since last call and reset
+ *
+ * @param ctx CPU stats
+ * @param percents Percent per slot (numTasks + 2: tasks, other, idle)
+ * @return uint32_t Number of samples
+ */
+uint32_t
+cpu_stats_collect(cpu_stats_t *ctx, float *percents);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __CPU_STATS_H
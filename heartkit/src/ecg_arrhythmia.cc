@@ -17,6 +17,7 @@
 #include "ns_ambiqsuite_harness.h"
 // TFLM
 #include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_utils.h"
 #include "tensorflow/lite/micro/tflite_bridge/micro_error_reporter.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 // Locals
@@ -27,75 +28,50 @@
 #include "ecg_arrhythmia.h"
 
 uint32_t
-ecg_arrhythmia_init(tf_model_context_t *ctx) {
-
-    size_t bytesUsed;
-    TfLiteStatus allocateStatus;
-
-    // Initialize TFLM backend
-    tflm_init_model(ctx);
-
-    // Load model
-    ctx->model = tflite::GetModel(ctx->buffer);
-    if (ctx->model->version() != TFLITE_SCHEMA_VERSION) {
-        TF_LITE_REPORT_ERROR(ctx->reporter, "Schema mismatch: given=%d != expected=%d.", ctx->model->version(), TFLITE_SCHEMA_VERSION);
+ecg_arrhythmia_check_io(const tf_model_context_t *ctx) {
+    // Window in (tflm_quantize_f32 zero-fills a longer input), [BATCH x CLASSES] out
+    if (tflite::ElementCount(*ctx->input->dims) < ECG_ARR_WINDOW_LEN || ctx->output->dims->size != 2) {
+        TF_LITE_REPORT_ERROR(ctx->reporter, "Input length < window=%d or output not [1 x classes].", ECG_ARR_WINDOW_LEN);
         return 1;
     }
-    // Initialize interpreter
-    if (ctx->interpreter != nullptr) { ctx->interpreter->Reset();}
-    static tflite::MicroInterpreter arrhythmia_interpreter(ctx->model, *(ctx->resolver), ctx->arena, ctx->arenaSize, nullptr, ctx->profiler);
-    ctx->interpreter = &arrhythmia_interpreter;
-
-    // Allocate tensors
-    allocateStatus = ctx->interpreter->AllocateTensors();
-    if (allocateStatus != kTfLiteOk) {
-        TF_LITE_REPORT_ERROR(ctx->reporter, "AllocateTensors() failed");
-        return 1;
-    }
-
-    // Check arena size
-    bytesUsed = ctx->interpreter->arena_used_bytes();
-    ns_lp_printf("[ARR] Arena used: %d bytes\n", bytesUsed);
-    if (bytesUsed > ctx->arenaSize) {
-        TF_LITE_REPORT_ERROR(ctx->reporter, "Arena mismatch: given=%d < expected=%d bytes.", ctx->arenaSize, bytesUsed);
+    if (ctx->output->dims->data[1] > ECG_ARR_NUM_CLASS) {
+        TF_LITE_REPORT_ERROR(ctx->reporter, "Output classes: given=%d > expected=%d.", ctx->output->dims->data[1], ECG_ARR_NUM_CLASS);
         return 1;
     }
-
-    // Store input and output pointers (assume single input/output tensor)
-    ctx->input = ctx->interpreter->input(0);
-    ctx->output = ctx->interpreter->output(0);
     return 0;
 }
 
 uint32_t
 ecg_arrhythmia_inference(tf_model_context_t *ctx, float32_t *ecgIn, float32_t threshold) {
-    float32_t yVal, yMax = 0;
-    uint32_t yMaxIdx = 0;
+    float32_t yOut[ECG_ARR_NUM_CLASS];
+    float32_t yMax = 0;
+    uint32_t numClasses, yMaxIdx = 0;
 
-    // Copy input and quantize
-    for (size_t i = 0; i < ECG_ARR_WINDOW_LEN; i++) {
-        if (ctx->input->quantization.type == kTfLiteAffineQuantization) {
-            ctx->input->data.int8[i] = ecgIn[i] / ctx->input->params.scale + ctx->input->params.zero_point;
-        } else {
-            ctx->input->data.f[i] = ecgIn[i];
-        }
+    // Model failed to (re)load- inconclusive
+    if (ctx->interpreter == nullptr) {
+        return 0;
     }
 
+    // Shared arena holds input/output tensors too
+    tflm_arena_lock();
+
+    // Copy input and quantize
+    tflm_quantize_f32(&ctx->inputQuant, ecgIn, ctx->input, ECG_ARR_WINDOW_LEN);
+
     // Invoke model
-    TfLiteStatus invokeStatus = ctx->interpreter->Invoke();
+    TfLiteStatus invokeStatus = tflm_invoke(ctx);
     if (invokeStatus != kTfLiteOk) {
+        tflm_arena_unlock();
         return invokeStatus;
     }
 
     // Copy output and dequantize
-    for (int i = 0; i < ctx->output->dims->data[1]; i++) { // CLASSES
-        if (ctx->output->quantization.type == kTfLiteAffineQuantization) {
-            yVal = ((float32_t)ctx->output->data.int8[i] - ctx->output->params.zero_point) * ctx->output->params.scale;
-        } else  {
-            yVal = ctx->output->data.f[i];
-        }
-        if ((i == 0) || (yVal > yMax)) {
-            yMax = yVal;
+    numClasses = ctx->output->dims->data[1];
+    tflm_dequantize_f32(&ctx->outputQuant, ctx->output, 0, yOut, numClasses);
+    tflm_arena_unlock();
+    for (uint32_t i = 0; i < numClasses; i++) {
+        if ((i == 0) || (yOut[i] > yMax)) {
+            yMax = yOut[i];
             yMaxIdx = i;
         }
     }
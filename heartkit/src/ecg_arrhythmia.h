@@ -18,13 +18,13 @@
 
 
 /**
- * @brief Initialize ECG arrhythmia model
+ * @brief Check ECG arrhythmia model input/output shapes (tf_model_context_t check_io)
  *
  * @param ctx TFLM model context
- * @return uint32_t
+ * @return uint32_t 0 if model fits the metrics stage
  */
 uint32_t
-ecg_arrhythmia_init(tf_model_context_t *ctx);
+ecg_arrhythmia_check_io(const tf_model_context_t *ctx);
 
 /**
  * @brief Run ECG arrhythmia model
@@ -18,13 +18,13 @@
 
 
 /**
- * @brief Initialize ECG denoise model
+ * @brief Check ECG denoise model input/output shapes (tf_model_context_t check_io)
  *
  * @param ctx TFLM model context
- * @return uint32_t
+ * @return uint32_t 0 if model fits the denoise stage
  */
 uint32_t
-ecg_denoise_init(tf_model_context_t *ctx);
+ecg_denoise_check_io(const tf_model_context_t *ctx);
 
 /**
  * @brief Run ECG denoise model
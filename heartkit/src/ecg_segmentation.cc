@@ -18,6 +18,7 @@
 // TFLM
 #include "tensorflow/lite/micro/kernels/micro_ops.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_utils.h"
 #include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "tensorflow/lite/micro/micro_profiler.h"
 #include "tensorflow/lite/micro/system_setup.h"
@@ -32,44 +33,17 @@
 #include "ecg_segmentation.h"
 
 uint32_t
-ecg_segmentation_init(tf_model_context_t *ctx) {
-
-    size_t bytesUsed;
-    TfLiteStatus allocateStatus;
-
-    // Initialize TFLM backend
-    tflm_init_model(ctx);
-
-    // Load model
-    ctx->model = tflite::GetModel(ctx->buffer);
-    if (ctx->model->version() != TFLITE_SCHEMA_VERSION) {
-        TF_LITE_REPORT_ERROR(ctx->reporter, "Schema mismatch: given=%d != expected=%d.", ctx->model->version(), TFLITE_SCHEMA_VERSION);
+ecg_segmentation_check_io(const tf_model_context_t *ctx) {
+    // Window in (tflm_quantize_f32 zero-fills a longer input), [BATCH x TIME x CLASSES] out
+    if (tflite::ElementCount(*ctx->input->dims) < ECG_SEG_WINDOW_LEN ||
+        ctx->output->dims->size != 3 || ctx->output->dims->data[1] < ECG_SEG_WINDOW_LEN) {
+        TF_LITE_REPORT_ERROR(ctx->reporter, "Input/output length < window=%d.", ECG_SEG_WINDOW_LEN);
         return 1;
     }
-
-    // Initialize interpreter
-    if (ctx->interpreter != nullptr) { ctx->interpreter->Reset(); }
-    static tflite::MicroInterpreter static_interpreter(ctx->model, *(ctx->resolver), ctx->arena, ctx->arenaSize, nullptr, ctx->profiler);
-    ctx->interpreter = &static_interpreter;
-
-    // Allocate tensors
-    allocateStatus = ctx->interpreter->AllocateTensors();
-    if (allocateStatus != kTfLiteOk) {
-        TF_LITE_REPORT_ERROR(ctx->reporter, "AllocateTensors() failed");
+    if (ctx->output->dims->data[2] > ECG_SEG_NUM_CLASS) {
+        TF_LITE_REPORT_ERROR(ctx->reporter, "Output classes: given=%d > expected=%d.", ctx->output->dims->data[2], ECG_SEG_NUM_CLASS);
         return 1;
     }
-
-    // Check arena size
-    bytesUsed = ctx->interpreter->arena_used_bytes();
-    ns_lp_printf("[SEG] Arena used: %d bytes\n", bytesUsed);
-    if (bytesUsed > ctx->arenaSize) {
-        TF_LITE_REPORT_ERROR(ctx->reporter, "Arena mismatch: given=%d < expected=%d bytes.", ctx->arenaSize, bytesUsed);
-        return 1;
-    }
-
-    // Store input and output pointers (assume single input/output tensor)
-    ctx->input = ctx->interpreter->input(0);
-    ctx->output = ctx->interpreter->output(0);
     return 0;
 }
 
@@ -94,37 +68,38 @@ ecg_physiokit_segmentation_inference(float32_t *data, uint16_t *segMask, uint32_
 
 uint32_t
 ecg_segmentation_inference(tf_model_context_t *ctx, float32_t *data, uint16_t *segMask, uint32_t padLen, float32_t threshold) {
-    uint32_t yIdx = 0;
+    uint32_t numClasses;
     uint8_t yMaxIdx = 0;
-    float32_t yVal = 0;
+    float32_t yRow[ECG_SEG_NUM_CLASS];
     float32_t yMax = 0;
     uint16_t qos = 0;
     float32_t avgQos = 0;
 
-    // Copy input and quantize
-    for (size_t i = 0; i < ECG_SEG_WINDOW_LEN; i++) {
-        if (ctx->input->quantization.type == kTfLiteAffineQuantization) {
-            ctx->input->data.int8[i] = data[i] / ctx->input->params.scale + ctx->input->params.zero_point;
-        } else {
-            ctx->input->data.f[i] = data[i];
-        }
+    // Model failed to (re)load
+    if (ctx->interpreter == nullptr) {
+        return 1;
     }
 
+    // Shared arena holds input/output tensors too
+    tflm_arena_lock();
+
+    // Copy input and quantize
+    tflm_quantize_f32(&ctx->inputQuant, data, ctx->input, ECG_SEG_WINDOW_LEN);
+
     // Invoke model
-    TfLiteStatus invokeStatus = ctx->interpreter->Invoke();
-    if (invokeStatus != kTfLiteOk) { return invokeStatus; }
+    TfLiteStatus invokeStatus = tflm_invoke(ctx);
+    if (invokeStatus != kTfLiteOk) {
+        tflm_arena_unlock();
+        return invokeStatus;
+    }
 
-    // Extract output and segmentation mask ([BATCH x TIME x CLASSES])
-    for (int i = padLen; i < ctx->output->dims->data[1] - (int)padLen; i++) {
-        for (int j = 0; j < ctx->output->dims->data[2]; j++) { // CLASSES
-            yIdx = i * ctx->output->dims->data[2] + j;
-            if (ctx->output->quantization.type == kTfLiteAffineQuantization) {
-                yVal = ((float32_t)ctx->output->data.int8[yIdx] - ctx->output->params.zero_point) * ctx->output->params.scale;
-            } else  {
-                yVal = ctx->output->data.f[yIdx];
-            }
-            if ((j == 0) || (yVal > yMax)) {
-                yMax = yVal;
+    // Extract output and segmentation mask ([BATCH x TIME x CLASSES]) over valid region
+    numClasses = ctx->output->dims->data[2];
+    for (uint32_t i = padLen; i < ECG_SEG_WINDOW_LEN - padLen; i++) {
+        tflm_dequantize_f32(&ctx->outputQuant, ctx->output, i * numClasses, yRow, numClasses);
+        for (uint32_t j = 0; j < numClasses; j++) {
+            if ((j == 0) || (yRow[j] > yMax)) {
+                yMax = yRow[j];
                 yMaxIdx = j;
             }
         }
@@ -136,7 +111,8 @@ ecg_segmentation_inference(tf_model_context_t *ctx, float32_t *data, uint16_t *s
         segMask[i] = yMax >= threshold ? yMaxIdx : 0;
         segMask[i] |= ((qos & SIG_MASK_QOS_MASK) << SIG_MASK_QOS_OFFSET);
     }
-    avgQos /= (ctx->output->dims->data[1] - 2 * padLen);
+    tflm_arena_unlock();
+    avgQos /= (ECG_SEG_WINDOW_LEN - 2 * padLen);
     ns_lp_printf("ECG Segmentation QoS: %f\n", avgQos);
 
     // if (avgQos < ECG_QOS_BAD_AVG_THRESH) {
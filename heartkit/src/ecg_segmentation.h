@@ -17,13 +17,13 @@
 #include "tflm.h"
 
 /**
- * @brief Initialize ECG segmentation model
+ * @brief Check ECG segmentation model input/output shapes (tf_model_context_t check_io)
  *
  * @param ctx TFLM model context
- * @return uint32_t
+ * @return uint32_t 0 if model fits the segmentation stage
  */
 uint32_t
-ecg_segmentation_init(tf_model_context_t *ctx);
+ecg_segmentation_check_io(const tf_model_context_t *ctx);
 
 /**
  * @brief Run ECG segmentation model
@@ -0,0 +1,59 @@
+/**
+ * @file governor.c
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Backlog-aware stage quality governor
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include <stdint.h>
+#include "governor.h"
+
+void
+governor_set_mode(governor_stage_t *ctx, uint8_t mode) {
+    ctx->requestedMode = mode;
+    ctx->mode = mode;
+    ctx->clearRuns = 0;
+    ctx->lastBacklog = 0;
+}
+
+uint32_t
+governor_request_mode(governor_stage_t *ctx, uint8_t mode) {
+    if (mode == ctx->requestedMode || (mode == ctx->mode && mode < ctx->requestedMode)) {
+        return 0;
+    }
+    governor_set_mode(ctx, mode);
+    return 1;
+}
+
+uint32_t
+governor_update(governor_stage_t *ctx, uint32_t backlog, uint32_t latencyUs) {
+    // A backlog only counts while it is not draining so one step down gets a chance to catch up
+    uint32_t behind = (backlog >= ctx->degradeBacklog && backlog >= ctx->lastBacklog) ||
+                      (ctx->degradeUs && latencyUs >= ctx->degradeUs);
+    ctx->lastBacklog = backlog;
+    if (behind) {
+        ctx->clearRuns = 0;
+        if (ctx->mode > ctx->minMode) {
+            ctx->mode--;
+            return 1;
+        }
+        return 0;
+    }
+    // Only a fully drained input counts toward restoring
+    if (backlog > 0) {
+        ctx->clearRuns = 0;
+        return 0;
+    }
+    if (ctx->mode >= ctx->requestedMode) {
+        return 0;
+    }
+    if (++ctx->clearRuns >= ctx->restoreRuns) {
+        ctx->clearRuns = 0;
+        ctx->mode++;
+        return 1;
+    }
+    return 0;
+}
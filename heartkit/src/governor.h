@@ -0,0 +1,78 @@
+/**
+ * @file governor.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Backlog-aware stage quality governor
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __GOVERNOR_H
+#define __GOVERNOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @brief Per-stage governor
+ * Modes are ordered by cost (0 = off, 1 = dsp, 2 = ai). When a stage falls
+ * behind (a backlog that is not draining, or run latency over budget) its
+ * effective mode steps down one level per run, never below minMode. Once it
+ * has kept up for restoreRuns consecutive runs it steps back up one level,
+ * never above the mode requested by the user.
+ *
+ */
+typedef struct {
+    uint8_t minMode;        // Lowest mode governor may select
+    uint32_t degradeBacklog; // Ready runs left after a run that steps mode down
+    uint32_t degradeUs;     // Run latency that steps mode down (0 = unused)
+    uint32_t restoreRuns;   // Consecutive caught-up runs before stepping up
+    // State
+    uint8_t requestedMode;  // Mode selected over UIO (upper bound)
+    uint8_t mode;           // Effective mode
+    uint32_t clearRuns;
+    uint32_t lastBacklog;
+} governor_stage_t;
+
+/**
+ * @brief Set user requested mode (also becomes the effective mode)
+ *
+ * @param ctx Governor stage
+ * @param mode Requested mode
+ */
+void
+governor_set_mode(governor_stage_t *ctx, uint8_t mode);
+
+/**
+ * @brief Apply mode requested over UIO unless it is an echo
+ * The dashboard sends back the whole UIO record whenever any field changes,
+ * including the effective mode the governor stepped down to. That mode is
+ * dropped so the governor can still restore the stage to the requested one.
+ *
+ * @param ctx Governor stage
+ * @param mode Mode received over UIO
+ * @return uint32_t 1 if mode was applied (see governor_set_mode), 0 otherwise
+ */
+uint32_t
+governor_request_mode(governor_stage_t *ctx, uint8_t mode);
+
+/**
+ * @brief Update effective mode after a stage run
+ *
+ * @param ctx Governor stage
+ * @param backlog Runs immediately ready after this run
+ * @param latencyUs Duration of this run
+ * @return uint32_t 1 if effective mode changed, 0 otherwise
+ */
+uint32_t
+governor_update(governor_stage_t *ctx, uint32_t backlog, uint32_t latencyUs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __GOVERNOR_H
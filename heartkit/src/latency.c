@@ -0,0 +1,96 @@
+/**
+ * @file latency.c
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Sample capture clock and log-scale latency histograms
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include <stdint.h>
+#include "latency.h"
+
+void
+latency_clock_capture(latency_clock_t *clk, uint32_t len, uint32_t nowUs, uint32_t periodUs) {
+    uint32_t b, slot, timeUs;
+    // Stamp every block whose first sample is in this capture
+    b = (clk->numSamples + LATENCY_BLOCK_LEN - 1) / LATENCY_BLOCK_LEN;
+    clk->numSamples += len;
+    for (; b * LATENCY_BLOCK_LEN < clk->numSamples; b++) {
+        slot = b & (LATENCY_CLOCK_LEN - 1);
+        timeUs = nowUs - (clk->numSamples - 1 - b * LATENCY_BLOCK_LEN) * periodUs;
+        // Invalidate slot while time is rewritten (pairs with lookup)
+        __atomic_store_n(&clk->block[slot], UINT32_MAX, __ATOMIC_RELEASE);
+        __atomic_store_n(&clk->timeUs[slot], timeUs, __ATOMIC_RELEASE);
+        __atomic_store_n(&clk->block[slot], b, __ATOMIC_RELEASE);
+    }
+}
+
+uint32_t
+latency_clock_lookup(const latency_clock_t *clk, uint32_t idx, uint32_t *timeUs) {
+    uint32_t b = idx / LATENCY_BLOCK_LEN;
+    uint32_t slot = b & (LATENCY_CLOCK_LEN - 1);
+    if (__atomic_load_n(&clk->block[slot], __ATOMIC_ACQUIRE) != b) { return 1; }
+    *timeUs = __atomic_load_n(&clk->timeUs[slot], __ATOMIC_ACQUIRE);
+    return __atomic_load_n(&clk->block[slot], __ATOMIC_ACQUIRE) != b;
+}
+
+static inline uint32_t
+latency_hist_bin(uint32_t us) {
+    uint32_t e, bin;
+    if (us < LATENCY_HIST_SUB_BINS) { return us; }
+    e = 31 - __builtin_clz(us);
+    bin = LATENCY_HIST_SUB_BINS * (e - 1) + ((us >> (e - 2)) & (LATENCY_HIST_SUB_BINS - 1));
+    return bin < LATENCY_HIST_BINS ? bin : LATENCY_HIST_BINS - 1;
+}
+
+static inline uint32_t
+latency_hist_bin_mid(uint32_t bin) {
+    uint32_t e, m;
+    if (bin < LATENCY_HIST_SUB_BINS) { return bin; }
+    e = bin / LATENCY_HIST_SUB_BINS + 1;
+    m = bin % LATENCY_HIST_SUB_BINS;
+    return ((LATENCY_HIST_SUB_BINS + m) << (e - 2)) + ((1UL << (e - 2)) >> 1);
+}
+
+void
+latency_hist_add(latency_hist_t *hist, uint32_t us) {
+    if (hist->total >= LATENCY_HIST_DECAY_LEN) {
+        hist->total = 0;
+        for (uint32_t i = 0; i < LATENCY_HIST_BINS; i++) {
+            hist->counts[i] >>= 1;
+            hist->total += hist->counts[i];
+        }
+    }
+    hist->counts[latency_hist_bin(us)]++;
+    hist->total++;
+}
+
+void
+latency_hist_record(latency_hist_t *hist, const latency_clock_t *clk, uint32_t idx, uint32_t len, uint32_t nowUs) {
+    uint32_t timeUs;
+    uint32_t end = idx + len;
+    // One entry per block (first sample of each block in range)
+    idx = (idx + LATENCY_BLOCK_LEN - 1) / LATENCY_BLOCK_LEN * LATENCY_BLOCK_LEN;
+    for (; idx < end; idx += LATENCY_BLOCK_LEN) {
+        if (latency_clock_lookup(clk, idx, &timeUs) == 0) {
+            latency_hist_add(hist, nowUs - timeUs);
+        }
+    }
+}
+
+uint32_t
+latency_hist_percentile(const latency_hist_t *hist, uint32_t pct) {
+    uint32_t total = 0, target, cum = 0;
+    for (uint32_t i = 0; i < LATENCY_HIST_BINS; i++) { total += hist->counts[i]; }
+    if (total == 0) { return 0; }
+    // Smallest bin with cumulative count >= pct of total
+    target = (total * pct + 99) / 100;
+    if (target == 0) { target = 1; }
+    for (uint32_t i = 0; i < LATENCY_HIST_BINS; i++) {
+        cum += hist->counts[i];
+        if (cum >= target) { return latency_hist_bin_mid(i); }
+    }
+    return latency_hist_bin_mid(LATENCY_HIST_BINS - 1);
+}
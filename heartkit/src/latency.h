@@ -0,0 +1,110 @@
+/**
+ * @file latency.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Sample capture clock and log-scale latency histograms
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __LATENCY_H
+#define __LATENCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define LATENCY_BLOCK_LEN (10)      // Samples per capture stamp
+#define LATENCY_CLOCK_LEN (256)     // Stamps kept (power of 2)
+#define LATENCY_HIST_SUB_BINS (4)   // Bins per octave
+#define LATENCY_HIST_BINS (104)     // Covers up to 2^26 us (~67 s)
+#define LATENCY_HIST_DECAY_LEN (4096) // Halve counts once total reaches this
+
+/**
+ * @brief Capture clock
+ * Records when each LATENCY_BLOCK_LEN block of a sample stream was captured
+ * so downstream stages can age samples by stream index alone. Single
+ * writer, any number of readers.
+ *
+ */
+typedef struct {
+    uint32_t numSamples; // Samples captured so far (writer only)
+    uint32_t block[LATENCY_CLOCK_LEN];
+    uint32_t timeUs[LATENCY_CLOCK_LEN];
+} latency_clock_t;
+
+/**
+ * @brief Log-scale latency histogram
+ * Each octave is split in LATENCY_HIST_SUB_BINS so percentiles are within
+ * ~12%. Counts decay by half once LATENCY_HIST_DECAY_LEN is reached so
+ * percentiles track recent behavior.
+ *
+ */
+typedef struct {
+    uint16_t counts[LATENCY_HIST_BINS];
+    uint32_t total;
+} latency_hist_t;
+
+/**
+ * @brief Stamp newly captured samples (writer side)
+ * Samples arrive in bursts (e.g. a sensor FIFO read) so each block is
+ * back-dated from the newest sample by its distance in sample periods.
+ *
+ * @param clk Capture clock
+ * @param len Number of samples appended to stream
+ * @param nowUs Capture time of newest sample
+ * @param periodUs Stream sample period
+ */
+void
+latency_clock_capture(latency_clock_t *clk, uint32_t len, uint32_t nowUs, uint32_t periodUs);
+
+/**
+ * @brief Look up capture time of sample
+ *
+ * @param clk Capture clock
+ * @param idx Sample stream index
+ * @param timeUs Capture time
+ * @return uint32_t 0 on success, 1 if stamp was overwritten or not yet written
+ */
+uint32_t
+latency_clock_lookup(const latency_clock_t *clk, uint32_t idx, uint32_t *timeUs);
+
+/**
+ * @brief Add latency sample to histogram
+ *
+ * @param hist Histogram
+ * @param us Latency in us
+ */
+void
+latency_hist_add(latency_hist_t *hist, uint32_t us);
+
+/**
+ * @brief Age samples [idx, idx + len) at nowUs and add one entry per block
+ *
+ * @param hist Histogram
+ * @param clk Capture clock
+ * @param idx First sample stream index
+ * @param len Number of samples
+ * @param nowUs Current time
+ */
+void
+latency_hist_record(latency_hist_t *hist, const latency_clock_t *clk, uint32_t idx, uint32_t len, uint32_t nowUs);
+
+/**
+ * @brief Get latency percentile (bin midpoint)
+ *
+ * @param hist Histogram
+ * @param pct Percentile (0-100)
+ * @return uint32_t Latency in us (0 if empty)
+ */
+uint32_t
+latency_hist_percentile(const latency_hist_t *hist, uint32_t pct);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LATENCY_H
@@ -34,7 +34,17 @@
 #include "ecg_arrhythmia.h"
 #include "metrics.h"
 #include "ringbuffer.h"
+#include "pipeline.h"
+#include "governor.h"
+#include "latency.h"
 #include "tileio.h"
+#if defined(HEARTKIT_HOST)
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "stimulus.h"
+#include "golden.h"
+#endif
 
 
 #if (configAPPLICATION_ALLOCATED_HEAP == 1)
@@ -45,9 +55,14 @@ uint8_t ucHeap[APP_HEAP_SIZE] __attribute__((aligned(4)));
 
 // RTOS Tasks
 static TaskHandle_t sensorTaskHandle;
-static TaskHandle_t processTaskHandle;
+static TaskHandle_t denoiseTaskHandle;
+static TaskHandle_t segmentationTaskHandle;
+static TaskHandle_t metricsTaskHandle;
+static TaskHandle_t txTaskHandle;
 static TaskHandle_t tioTaskHandle;
+#if !defined(HEARTKIT_HOST)
 static TaskHandle_t appSetupTask;
+#endif
 
 tio_context_t tioCtx = {
     .uio_update_cb = NULL,
@@ -60,6 +75,8 @@ tio_context_t tioCtx = {
 
 /**
  * @brief Flush pipeline buffers
+ * NOTE: Flushing is a consumer-side operation- stage tasks must not be
+ * running. The TX reader of rbEcgSegOut is TxTask's and drains on its own.
  *
  */
 void flush_pipeline() {
@@ -67,11 +84,7 @@ void flush_pipeline() {
     ringbuffer_flush(&rbEcgDen);
     ringbuffer_flush(&rbEcgRawSeg);
     ringbuffer_flush(&rbEcgSeg);
-    ringbuffer_flush(&rbEcgMet);
-    ringbuffer_flush(&rbEcgMaskMet);
-    ringbuffer_flush(&rbEcgRawTx);
-    ringbuffer_flush(&rbEcgDenTx);
-    ringbuffer_flush(&rbEcgMaskTx);
+    ringbuffer_flush(&rbEcgSegOut, EcgReaderMet);
 }
 
 void
@@ -93,33 +106,39 @@ set_noise_inputs(uint8_t bw, uint8_t ma, uint8_t em) {
     ns_lp_printf("Noise Level: %d,%d,%d\n", appState.bwNoiseLevel, appState.maNoiseLevel, appState.emNoiseLevel);
 }
 
+// Latest mode received over UIO per stage (StageModeNone once taken)- the
+// stage task applies or drops it as an echo (see update_stage_mode)
+static constexpr uint8_t StageModeNone = 0xFF;
+static std::atomic<uint8_t> stageModeRequests[PipelineNumStages];
+
 void
 set_denoise_mode(uint8_t mode) {
-    mode = MIN(mode, 2);
-    if (appState.denoiseMode != mode) {
-        appState.denoiseMode = mode;
-        ns_lp_printf("Denoise Mode: %d\n", appState.denoiseMode);
-    }
+    stageModeRequests[PipelineStageDenoise].store(MIN(mode, 2), std::memory_order_release);
 }
 
 void
 set_segmentation_mode(uint8_t mode) {
-    mode = MIN(mode, 2);
-    if (appState.segMode != mode) {
-        appState.segMode = mode;
-        ns_lp_printf("Segmentation Mode: %d\n", appState.segMode);
-    }
+    stageModeRequests[PipelineStageSegmentation].store(MIN(mode, 2), std::memory_order_release);
 }
 
 void
 set_arrhythmia_mode(uint8_t mode) {
-    mode = MIN(mode, 2);
-    if (appState.arrMode != mode) {
-        appState.arrMode = mode;
-        ns_lp_printf("Arrhythmia Mode: %d\n", appState.arrMode);
-    }
+    stageModeRequests[PipelineStageMetrics].store(MIN(mode, 2), std::memory_order_release);
 }
 
+void
+set_stage_hops(uint8_t denPad, uint8_t segPad, uint8_t metHop) {
+    denPad = MIN(denPad, ECG_DEN_MAX_PAD_LEN);
+    segPad = MIN(segPad, ECG_SEG_MAX_PAD_LEN);
+    metHop = CLIP(metHop, ECG_MET_MIN_HOP_LEN / ECG_MET_HOP_UNIT_LEN, ECG_MET_WINDOW_LEN / ECG_MET_HOP_UNIT_LEN);
+    // Stage tasks pick up the change before their next run (see update_stage_hop)
+    if (appState.denPadLen != denPad || appState.segPadLen != segPad || appState.metHop != metHop) {
+        appState.denPadLen = denPad;
+        appState.segPadLen = segPad;
+        appState.metHop = metHop;
+        ns_lp_printf("Stage Pad/Hop: %d,%d,%d\n", appState.denPadLen, appState.segPadLen, appState.metHop);
+    }
+}
 
 void
 set_speed_mode(uint8_t mode) {
@@ -144,35 +163,86 @@ fetch_leds_state() {
 // TIO
 ////////////////////////////////////////////////////////////////
 
+// Records TxTask sends on request (TxTask is the only Tileio sender)
+enum TxRequest { TxRequestMetrics = 1 << 0, TxRequestUio = 1 << 1, TxRequestOpProfile = 1 << 2 };
+typedef enum TxRequest TxRequest;
+
+static std::atomic<uint32_t> txRequests{0};
+
+/**
+ * @brief Request TxTask to send Tileio records on its next slot
+ *
+ * @param requests Bitmask of TxRequest
+ */
+void request_tx(uint32_t requests) {
+    txRequests.fetch_or(requests, std::memory_order_release);
+    if (txTaskHandle != NULL) {
+        xTaskNotifyGive(txTaskHandle);
+    }
+}
+
+
+/**
+ * @brief Pack segmentation output into slot0 frames and publish to rbEcgSegOut
+ * Frames are written once for both readers (metrics and TX). Raw samples are
+ * popped from rbEcgRawSeg to stay aligned with den/mask. Both are stored at
+ * ECG_Q15_SCALE (= 1 / TIO_SLOT0_SCALE) so are already in wire format.
+ *
+ * @param ecgDen Denoised ECG (q15)
+ * @param ecgMask Segmentation mask
+ * @param len Number of samples
+ */
+void push_slot0_frames(const q15_t *ecgDen, const uint16_t *ecgMask, size_t len) {
+    q15_t ecgRaw[TIO_SLOT0_FRAMES_PER_PKT];
+    tio_ecg_frame_t frames[TIO_SLOT0_FRAMES_PER_PKT];
+    size_t numSamples, numRaw;
+    for (size_t i = 0; i < len; i += numSamples) {
+        numSamples = MIN(len - i, TIO_SLOT0_FRAMES_PER_PKT);
+        // Denoise pushes raw in step- a shortfall only blanks raw so metrics still get den/mask
+        numRaw = ringbuffer_pop(&rbEcgRawSeg, ecgRaw, numSamples);
+        for (size_t j = 0; j < numSamples; j++) {
+            frames[j].mask = (int16_t)ecgMask[i + j];
+            frames[j].raw = j < numRaw ? ecgRaw[j] : 0;
+            frames[j].den = ecgDen[i + j];
+        }
+        ringbuffer_push(&rbEcgSegOut, frames, numSamples);
+    }
+}
+
+// Stream index of rbEcgDen and rbEcgSeg tails
+static uint32_t denStreamIdx = 0, segStreamIdx = 0;
+
+// Stream index of next sample each stage emits and of the first it emitted. The
+// first run emits from its current pad; after that output stays contiguous across
+// pad changes, so seg sample i is rbEcgDen sample i + denEmitStart. The ring push
+// that follows publishes *EmitStart to downstream tasks.
+static uint32_t denEmitIdx = 0, segEmitIdx = 0;
+static uint32_t denEmitStart = 0, segEmitStart = 0;
+static bool denEmitting = false, segEmitting = false;
+
+// TX reader stream index of next frame (frame i is rbEcgDen sample i + segEmitStart + denEmitStart)
+static uint32_t txStreamIdx = 0;
+static uint32_t txDropped = 0;
 
 /**
  * @brief Send slot0 (ECG) signals to TIO
  *
  */
 void send_slot0_signals() {
-    int16_t buffer[120];
-    float32_t ecgRaw, ecgDen;
-    uint32_t length;
-    size_t numSamples = MIN3(
-        ringbuffer_len(&rbEcgRawTx),
-        ringbuffer_len(&rbEcgDenTx),
-        ringbuffer_len(&rbEcgMaskTx)
+    tio_ecg_frame_t frames[TIO_SLOT0_FRAMES_PER_PKT];
+    uint32_t dropped = rbEcgSegOut.dropped(EcgReaderTx);
+    size_t numFrames = ringbuffer_pop(&rbEcgSegOut, EcgReaderTx, frames, TIO_SLOT0_FRAMES_PER_PKT);
+    // Frames skipped while the link lagged still advance the stream
+    txStreamIdx += dropped - txDropped;
+    txDropped = dropped;
+    if (numFrames == 0) { return; }
+    tio_send_slot_data(0, 0, (uint8_t *)frames, numFrames * sizeof(tio_ecg_frame_t));
+    latency_hist_record(
+        &latencyHists[LatencyPointTx], &ecgLatClock,
+        txStreamIdx + segEmitStart + denEmitStart, numFrames,
+        ns_us_ticker_read(&timerCfg)
     );
-    numSamples = MIN(
-        numSamples,
-        240/(3*sizeof(int16_t))
-    );
-    if (numSamples == 0) { return; }
-    length = 0;
-    for (size_t i = 0; i < numSamples; i++) {
-        ringbuffer_pop(&rbEcgMaskTx, &buffer[length + 0], 1);
-        ringbuffer_pop(&rbEcgRawTx, &ecgRaw, 1);
-        ringbuffer_pop(&rbEcgDenTx, &ecgDen, 1);
-        buffer[length + 1] = (int16_t)CLIP(TIO_SLOT0_SCALE*ecgRaw, -32768, 32767);
-        buffer[length + 2] = (int16_t)CLIP(TIO_SLOT0_SCALE*ecgDen, -32768, 32767);
-        length += 3;
-    }
-    tio_send_slot_data(0, 0, (uint8_t *)buffer, length * sizeof(int16_t));
+    txStreamIdx += numFrames;
 }
 
 /**
@@ -192,12 +262,206 @@ void send_slot0_metrics() {
     tio_send_slot_data(0, 1, (uint8_t *)buffer, 8*sizeof(float32_t));
 }
 
+/**
+ * @brief Send ring buffer telemetry to TIO
+ * Record is rb_stats_t[] in pipeline order: sensor, den, rawSeg, seg,
+ * segOut (metrics reader), segOut (TX reader, dropped includes skipped frames)
+ *
+ */
+void send_ring_stats() {
+    rb_stats_t stats[6];
+    stats[0] = ringbuffer_stats(&rbEcgSensor);
+    stats[1] = ringbuffer_stats(&rbEcgDen);
+    stats[2] = ringbuffer_stats(&rbEcgRawSeg);
+    stats[3] = ringbuffer_stats(&rbEcgSeg);
+    stats[4] = ringbuffer_stats(&rbEcgSegOut, EcgReaderMet);
+    stats[5] = ringbuffer_stats(&rbEcgSegOut, EcgReaderTx);
+    tio_send_slot_data(TIO_RB_STATS_SLOT, 1, (uint8_t *)stats, sizeof(stats));
+}
+
+/**
+ * @brief Send latency percentiles to TIO
+ * Record is float32[] of p50, p95, p99 (ms) per LatencyPoint: sensor -> denoise,
+ * sensor -> segment, sensor -> tx
+ *
+ */
+void send_latency_stats() {
+    float32_t buffer[3*LatencyNumPoints];
+    for (uint32_t i = 0; i < LatencyNumPoints; i++) {
+        buffer[3*i + 0] = latency_hist_percentile(&latencyHists[i], 50)/1000.0f;
+        buffer[3*i + 1] = latency_hist_percentile(&latencyHists[i], 95)/1000.0f;
+        buffer[3*i + 2] = latency_hist_percentile(&latencyHists[i], 99)/1000.0f;
+    }
+    tio_send_slot_data(TIO_LATENCY_SLOT, 1, (uint8_t *)buffer, sizeof(buffer));
+}
+
+#if defined(CPU_STATS)
+#if (INCLUDE_xTaskGetCurrentTaskHandle == 0)
+// HACK: the prebuilt kernel has neither run-time stats nor xTaskGetCurrentTaskHandle()
+// so read its private current task pointer. Only current_task() touches it- drop this
+// once the kernel is built with INCLUDE_xTaskGetCurrentTaskHandle.
+extern "C" void * volatile pxCurrentTCB;
+#endif
+
+/**
+ * @brief Handle of running task (ISR safe)
+ *
+ */
+static inline void *current_task() {
+#if (INCLUDE_xTaskGetCurrentTaskHandle == 1)
+    return xTaskGetCurrentTaskHandle();
+#else
+    return pxCurrentTCB;
+#endif
+}
+
+/**
+ * @brief Record running task in cpuStats (timer2Cfg ISR)
+ * Without INCLUDE_xTaskGetIdleTaskHandle (0 in the prebuilt kernel) idle is
+ * matched by its default name the first time it runs.
+ *
+ */
+void sample_running_task(ns_timer_config_t *cfg) {
+    void *task = current_task();
+#if (INCLUDE_xTaskGetIdleTaskHandle == 0)
+    if (cpuStats.idleTask == NULL && task != NULL && strcmp(pcTaskGetName((TaskHandle_t)task), "IDLE") == 0) {
+        cpu_stats_register_idle(&cpuStats, task);
+    }
+#endif
+    cpu_stats_sample(&cpuStats, task);
+}
+
+/**
+ * @brief Send per-task CPU share to TIO
+ * Record is float32[] of percent per CpuTask followed by other
+ * (unregistered tasks) and idle since last call. Also updates cpuPercUtil.
+ *
+ */
+void send_cpu_stats() {
+    float32_t buffer[CpuNumTasks + 2];
+    if (cpu_stats_collect(&cpuStats, buffer)) {
+        appMetResults.cpuPercUtil = 100.0f - buffer[CpuNumTasks + 1];
+    }
+    tio_send_slot_data(TIO_CPU_STATS_SLOT, 1, (uint8_t *)buffer, sizeof(buffer));
+}
+#else
+// Stage task busy time since last metrics report
+static std::atomic<uint32_t> stageBusyUs{0};
+static uint32_t cpuReportUs = 0;
+
+/**
+ * @brief Estimate cpuPercUtil from stage task busy time
+ * Without CPU_STATS there is no sampling timer (it would keep the core out
+ * of deep sleep) so sensor, TX and BLE time is not counted.
+ *
+ */
+void send_cpu_stats() {
+    uint32_t elapsedUs = ns_us_ticker_read(&timerCfg) - cpuReportUs;
+    cpuReportUs += elapsedUs;
+    appMetResults.cpuPercUtil = MIN(100.0f*stageBusyUs.exchange(0, std::memory_order_relaxed)/elapsedUs, 100.0f);
+}
+#endif
+
+#if defined(TFLM_PROFILE)
+// Record index of next per-op profile page
+static uint32_t opProfileIdx = 0;
+
+/**
+ * @brief Send one page of per-op profile to TIO
+ * Record is tflm_op_record_t[] (see tflm.h) of the ops of all models from
+ * record index first.
+ *
+ * @param first Index of first record
+ * @return uint32_t Number of records sent
+ */
+uint32_t send_op_profile_page(uint32_t first) {
+    tflm_op_record_t records[TIO_OP_PROFILE_RECORDS_PER_PKT];
+    uint32_t numRecords = tflm_profile_records(records, first, TIO_OP_PROFILE_RECORDS_PER_PKT);
+    if (numRecords) {
+        tio_send_slot_data(TIO_OP_PROFILE_SLOT, 1, (uint8_t *)records, numRecords * sizeof(tflm_op_record_t));
+    }
+    return numRecords;
+}
+
+/**
+ * @brief Send next per-op profile page (cycles through all pages)
+ *
+ */
+void send_op_profile() {
+    uint32_t numRecords = send_op_profile_page(opProfileIdx);
+    if (numRecords == 0) {
+        numRecords = send_op_profile_page(0);
+        opProfileIdx = 0;
+    }
+    opProfileIdx += numRecords;
+}
+
+/**
+ * @brief Send all per-op profile pages, log them and start a new profile
+ *
+ */
+void dump_op_profile() {
+    uint32_t numRecords;
+    for (uint32_t first = 0; (numRecords = send_op_profile_page(first)) > 0; first += numRecords) {
+        vTaskDelay(pdMS_TO_TICKS(TIO_SLOT0_TX_PERIOD_MS));
+    }
+    tflm_profile_log();
+    tflm_profile_reset();
+    opProfileIdx = 0;
+}
+#endif
+
+#if defined(TFLM_MODEL_SLOT)
+// Model swaps applied by the task driving each stage (see update_stage_model)
+enum ModelRequest { ModelRequestLoad = 1 << 0, ModelRequestRevert = 1 << 1 };
+typedef enum ModelRequest ModelRequest;
+
+static std::atomic<uint32_t> stageModelRequests[PipelineNumStages];
+
+/**
+ * @brief Handle model transfer packet (see model_slot.h)
+ * A committed model is loaded by the stage task before its next run so a
+ * model is never swapped mid-inference.
+ *
+ * @param data Packet
+ * @param length Packet length
+ */
+void received_model_packet(const uint8_t *data, uint32_t length) {
+    uint8_t stage = 0;
+    uint32_t event = ModelSlotEventError;
+    if (length >= MODEL_SLOT_HDR_LEN && data[1] < PipelineNumStages) {
+        event = model_slot_receive(&modelSlot, data, length, &stage);
+    }
+    if (event == ModelSlotEventError) {
+        ns_lp_printf("<MODEL rejected cmd=%d (%d of %d bytes) >\n", length ? data[0] : -1, modelSlot.received, modelSlot.len);
+    } else if (event == ModelSlotEventLoad && tflm_model_verify(modelSlot.buffer, modelSlot.len)) {
+        // Truncated or malformed flatbuffer would read out of bounds inside TFLM
+        modelSlot.state = ModelSlotEmpty;
+        ns_lp_printf("<MODEL rejected invalid flatbuffer (%d bytes) >\n", modelSlot.len);
+    } else if (event == ModelSlotEventLoad) {
+        stageModelRequests[stage].fetch_or(ModelRequestLoad, std::memory_order_release);
+    } else if (event == ModelSlotEventRevert) {
+        stageModelRequests[stage].fetch_or(ModelRequestRevert, std::memory_order_release);
+    }
+}
+#endif
+
 void received_slot_data(uint8_t slot, uint8_t slot_type, const uint8_t *data, uint32_t length) {
-    // No slot data expected
+#if defined(TFLM_MODEL_SLOT)
+    if (slot == TIO_MODEL_SLOT && slot_type == 1) {
+        received_model_packet(data, length);
+    }
+#endif
+#if defined(TFLM_PROFILE)
+    // Any data on the profile slot requests a per-op profile dump
+    if (slot == TIO_OP_PROFILE_SLOT) {
+        request_tx(TxRequestOpProfile);
+    }
+#endif
 }
 
 void send_uio_state() {
-    uint8_t uioBuffer[8];
+    uint8_t uioBuffer[TIO_UIO_LEN] = {0};
     uioBuffer[TIO_UIO_INPUT_SEL_IDX] = appState.inputSource;
     uioBuffer[TIO_UIO_BW_NOISE_IDX] = appState.bwNoiseLevel;
     uioBuffer[TIO_UIO_MA_NOISE_IDX] = appState.maNoiseLevel;
@@ -206,7 +470,10 @@ void send_uio_state() {
     uioBuffer[TIO_UIO_DEN_MODE_IDX] = appState.denoiseMode;
     uioBuffer[TIO_UIO_SEG_MODE_IDX] = appState.segMode;
     uioBuffer[TIO_UIO_ARR_MODE_IDX] = appState.arrMode;
-    tio_send_uio_state(uioBuffer, 8);
+    uioBuffer[TIO_UIO_DEN_PAD_IDX] = appState.denPadLen;
+    uioBuffer[TIO_UIO_SEG_PAD_IDX] = appState.segPadLen;
+    uioBuffer[TIO_UIO_MET_HOP_IDX] = appState.metHop;
+    tio_send_uio_state(uioBuffer, TIO_UIO_LEN);
 }
 
 void received_uio_state(const uint8_t *data, uint32_t length) {
@@ -220,13 +487,20 @@ void received_uio_state(const uint8_t *data, uint32_t length) {
     set_denoise_mode(data[TIO_UIO_DEN_MODE_IDX]);
     set_segmentation_mode(data[TIO_UIO_SEG_MODE_IDX]);
     set_arrhythmia_mode(data[TIO_UIO_ARR_MODE_IDX]);
-    send_uio_state();
+    // Older dashboards send 8 bytes- leave pad/hop as is
+    if (length >= TIO_UIO_LEN) {
+        set_stage_hops(data[TIO_UIO_DEN_PAD_IDX], data[TIO_UIO_SEG_PAD_IDX], data[TIO_UIO_MET_HOP_IDX]);
+    }
+    request_tx(TxRequestUio);
 }
 
 ////////////////////////////////////////////////////////////////
 // SENSOR TASK BLOCK
 ////////////////////////////////////////////////////////////////
 
+// Time of last sensor read (capture stamp for samples it yields)
+static uint32_t sensorCaptureUs = 0;
+
 /**
  * @brief Extract sensor data
  *
@@ -235,28 +509,26 @@ void received_uio_state(const uint8_t *data, uint32_t length) {
 uint32_t
 extract_sensor_data(size_t numSamples) {
     int32_t val;
+    sensorCaptureUs = ns_us_ticker_read(&timerCfg);
 
-    float32_t val_f32;
+    q15_t val_q15;
     size_t idx;
     for (size_t i = 0; i < numSamples; i++) {
         for (size_t j = 0; j < sensorCtx.maxCfg->numSlots; j++) {
             idx = sensorCtx.maxCfg->numSlots * i + j;
             if (sensorCtx.maxCfg->fifoSlotConfigs[j] == Max86150SlotEcg) {
                 val = sensorCtx.buffer[idx];
-                if (sensorCtx.inputSource < NUM_INPUT_PTS) {
-                    val_f32 = val;
-                } else {
-                    val_f32  = val & (1 << 17) ? val - (1 << 18) : val; // 2's complement
+                // Only the 18-bit ADC is wider than q15- stimulus is stored as is
+                if (sensorCtx.inputSource >= NUM_INPUT_PTS) {
+                    val = val & (1 << 17) ? val - (1 << 18) : val; // 2's complement
+                    val >>= SENSOR_Q15_SHIFT;
                 }
-                ringbuffer_push(&rbEcgSensor, &val_f32, 1);
+                val_q15 = (q15_t)val;
+                ringbuffer_push(&rbEcgSensor, &val_q15, 1);
             } else if (sensorCtx.maxCfg->fifoSlotConfigs[j] == Max86150SlotPpgLed1) {
                 val = sensorCtx.buffer[idx];
-                val_f32 = val;
-                // ringbuffer_push(&rbPpg1Led2Sensor, &val_f32, 1);
             } else if (sensorCtx.maxCfg->fifoSlotConfigs[j] == Max86150SlotPpgLed2) {
                 val = sensorCtx.buffer[idx];
-                // val_f32 = val;
-                // ringbuffer_push(&rbPpg2Led2Sensor, &val_f32, 1);
             }
         }
     }
@@ -265,26 +537,38 @@ extract_sensor_data(size_t numSamples) {
 
 /**
  * @brief Preprocess sensor data
+ * SensorTask is the sole producer of rbEcgDen and the denoise task its sole consumer
+ * (lock-free SPSC handoff, see typed_ringbuffer.h). The denoise task is notified
+ * as soon as a full denoise window is available.
  *
  */
 void preprocess_sensor_data() {
-    size_t numSamples;
+    size_t numSamples, numDen = 0;
     // Downsample sensor data to slots
     numSamples = ringbuffer_len(&rbEcgSensor);
     for (size_t i = 0; i < numSamples/ECG_DS_RATE; i++) {
         ringbuffer_seek(&rbEcgSensor, ECG_DS_RATE - 1);
-        ringbuffer_transfer(&rbEcgSensor, &rbEcgDen, 1);
+        numDen += ringbuffer_transfer(&rbEcgSensor, &rbEcgDen, 1);
     }
+    // Stamp samples by rbEcgDen stream index. FIFO read time is the capture of the
+    // newest sensor sample- any left in rbEcgSensor are newer than the last den sample.
+    latency_clock_capture(
+        &ecgLatClock, numDen,
+        sensorCaptureUs - ringbuffer_len(&rbEcgSensor) * (1000000 / SENSOR_RATE),
+        1000000 / ECG_SAMPLE_RATE
+    );
 }
 
 void SensorTask(void *pvParameters) {
     size_t numSamples, reqSamples;
-    uint32_t remUs = 0, tickUs = 0;
-    ns_timer_clear(&timer2Cfg);
+    uint32_t remUs = 0, tickUs = 0, nowUs;
+    uint32_t lastUs = ns_us_ticker_read(&timerCfg);
+    uint32_t delayMs = SENSOR_MAX_DELAY_MS;
     while (true) {
-        vTaskDelay(pdMS_TO_TICKS(80)); // Delay for 16 samples (200Hz)
-        tickUs = ns_us_ticker_read(&timer2Cfg) + remUs;
-        ns_timer_clear(&timer2Cfg);
+        vTaskDelay(pdMS_TO_TICKS(delayMs));
+        nowUs = ns_us_ticker_read(&timerCfg);
+        tickUs = nowUs - lastUs + remUs;
+        lastUs = nowUs;
         if (sensorCtx.inputSource < NUM_INPUT_PTS) {
             reqSamples = MIN(tickUs/1000/SENSOR_RATE_MS, 32),
             remUs = tickUs - 1000*reqSamples*SENSOR_RATE_MS;
@@ -297,172 +581,516 @@ void SensorTask(void *pvParameters) {
         if (numSamples >= 30) {
             ns_lp_printf("<SENSOR %d >\n", numSamples);
         }
+        // Wake when the next denoise hop completes but before the FIFO fills
+        delayMs = (ECG_DEN_WINDOW_LEN - MIN(ringbuffer_len(&rbEcgDen), ECG_DEN_WINDOW_LEN)) * ECG_DS_RATE * SENSOR_RATE_MS;
+        delayMs = CLIP(delayMs, SENSOR_MIN_DELAY_MS, SENSOR_MAX_DELAY_MS);
     }
 }
 
 
 ////////////////////////////////////////////////////////////////
-// PROCESS TASK BLOCK
+// PIPELINE TASK BLOCK
 ////////////////////////////////////////////////////////////////
 
-void ProcessTask(void *pvParameters) {
+#if (INCLUDE_uxTaskGetStackHighWaterMark == 1) || (configCHECK_FOR_STACK_OVERFLOW > 1)
+/**
+ * @brief Min free stack (words) of task since creation
+ * The prebuilt kernel lacks uxTaskGetStackHighWaterMark() but overflow
+ * checking (configCHECK_FOR_STACK_OVERFLOW = 2) fills new stacks with 0xA5,
+ * so count untouched words up from the stack base as the kernel would.
+ * StaticTask_t mirrors the private TCB layout- pxDummy6 is pxStack.
+ *
+ * @param task Task handle
+ * @return uint32_t Free words
+ */
+static uint32_t
+task_stack_watermark(TaskHandle_t task) {
+#if (INCLUDE_uxTaskGetStackHighWaterMark == 1)
+    return uxTaskGetStackHighWaterMark(task);
+#else
+    const uint32_t *stack = (const uint32_t *)((const StaticTask_t *)task)->pxDummy6;
+    uint32_t numFree = 0;
+    while (stack[numFree] == 0xA5A5A5A5) { numFree++; }
+    return numFree;
+#endif
+}
+
+/**
+ * @brief Print min free stack (words) of pipeline tasks to size *_TASK_STACK_LEN
+ *
+ */
+void print_stack_watermarks() {
+    ns_lp_printf(
+        "<STACK den=%d seg=%d met=%d tx=%d >\n",
+        task_stack_watermark(denoiseTaskHandle),
+        task_stack_watermark(segmentationTaskHandle),
+        task_stack_watermark(metricsTaskHandle),
+        task_stack_watermark(txTaskHandle)
+    );
+}
+#endif
+
+/**
+ * @brief Denoise a single window into ecgDenInout
+ * Also pushes the noisy emitted region [emitOff, window - pad) to rbEcgRawSeg.
+ *
+ * @param ecgDenWin q15 window (STIMULUS_Q15_SCALE or SENSOR_Q15_SCALE by input source)
+ * @param padLen Context on each side of valid region
+ * @param emitOff Window offset of first emitted sample
+ * @return uint32_t Error code
+ */
+uint32_t denoise_window(const q15_t *ecgDenWin, uint32_t padLen, uint32_t emitOff) {
     uint32_t err = 0;
-    uint32_t delayUs = 0, tickUs = 0;
-    uint32_t deltaUs = 0;
-    float32_t cpuIdleMs = 0, cpuBusyMs = 0;
 
-    while (true) {
-        err = 0;
-        ns_timer_clear(&timerCfg);
+    // Preprocess signal and add noise based on input
+    if (sensorCtx.inputSource < NUM_INPUT_PTS) {
+        // Keep clean signal for cosine similarity
+        ringbuffer_q15_to_f32(ecgDenWin, ecgDenNoise, ECG_DEN_WINDOW_LEN, STIMULUS_Q15_SCALE);
+        pk_standardize_f32(ecgDenNoise, ecgDenNoise, ECG_DEN_WINDOW_LEN, NORM_STD_EPS);
+        nstdb_add_bw_noise(ecgDenNoise, ecgDenInout, ECG_DEN_WINDOW_LEN, (float32_t)appState.bwNoiseLevel*2.0e-5);
+        nstdb_add_ma_noise(ecgDenInout, ecgDenInout, ECG_DEN_WINDOW_LEN, (float32_t)appState.maNoiseLevel*1.0e-5);
+        nstdb_add_em_noise(ecgDenInout, ecgDenInout, ECG_DEN_WINDOW_LEN, (float32_t)appState.emNoiseLevel*1.0e-5);
+    } else {
+        ringbuffer_q15_to_f32(ecgDenWin, ecgDenInout, ECG_DEN_WINDOW_LEN, SENSOR_Q15_SCALE);
+        pk_standardize_f32(ecgDenInout, ecgDenInout, ECG_DEN_WINDOW_LEN, NORM_STD_EPS);
+    }
 
-        ///////////////////////////////////////////////
-        // DENOSING SIGNAL BLOCK
-        ///////////////////////////////////////////////
-        if (ringbuffer_len(&rbEcgDen) >= ECG_DEN_WINDOW_LEN) {
-            tickUs = ns_us_ticker_read(&timerCfg);
+    // Copy noisy signal to seg buffer
+    ringbuffer_push_f32(&rbEcgRawSeg, &ecgDenInout[emitOff], ECG_DEN_WINDOW_LEN - padLen - emitOff, ECG_Q15_SCALE);
 
-            // Grab data from ringbuffer
-            ringbuffer_peek(&rbEcgDen, ecgDenInout, ECG_DEN_WINDOW_LEN);
+    // Apply biquad filter for DSP and AI modes
+    if (appState.denoiseMode == DenoiseModeDsp) {
+        err = pk_apply_biquad_filtfilt_f32(&ecgFilterCtx, ecgDenInout, ecgDenInout, ECG_DEN_WINDOW_LEN, ecgDenScratch);
+    }
+    // Denoise using AI model
+    else if (appState.denoiseMode == DenoiseModeAi) {
+        err = ecg_denoise_inference(&ecgDenModelCtx, ecgDenInout, ecgDenInout, 0, ECG_DEN_THRESHOLD);
+    } else {
+        err = 0;
+    }
 
-            // Preprocess signal
-            pk_standardize_f32(ecgDenInout, ecgDenInout, ECG_DEN_WINDOW_LEN, NORM_STD_EPS);
+    // Compute cosine similarity
+    if (sensorCtx.inputSource < NUM_INPUT_PTS) {
+        cosine_similarity_f32(
+            &ecgDenInout[padLen],
+            &ecgDenNoise[padLen],
+            ECG_DEN_WINDOW_LEN - 2 * padLen,
+            &appMetResults.denoiseCossim
+        );
+    // Skip for live sensor mode
+    } else {
+        appMetResults.denoiseCossim = 1.0;
+    }
+    appMetResults.denoiseCossim *= 100.0;
+    return err;
+}
 
-            // Copy clean signal to buffer
-            arm_copy_f32(ecgDenInout, ecgDenNoise, ECG_DEN_WINDOW_LEN);
+/**
+ * @brief Denoise stage: rbEcgDen -> rbEcgRawSeg (noisy), rbEcgSeg (clean)
+ * A backlog is processed as a batch of up to ECG_DEN_MAX_BATCH windows.
+ * The first window emits from denEmitIdx so a pad change neither skips
+ * nor repeats samples.
+ *
+ * @param stage Pipeline stage (current pad/hop)
+ * @param numWindows Number of windows (hop apart) at input tail
+ */
+void denoise_stage_run(const pipeline_stage_t *stage, uint32_t numWindows) {
+    uint32_t err = 0;
+    uint32_t tickUs = ns_us_ticker_read(&timerCfg);
+    uint32_t deltaUs, emitOff, emitLen, outLen = 0;
 
-            // Add noise to signal based on input
-            if (sensorCtx.inputSource < NUM_INPUT_PTS) {
-                nstdb_add_bw_noise(ecgDenInout, ecgDenInout, ECG_DEN_WINDOW_LEN, (float32_t)appState.bwNoiseLevel*2.0e-5);
-                nstdb_add_ma_noise(ecgDenInout, ecgDenInout, ECG_DEN_WINDOW_LEN, (float32_t)appState.maNoiseLevel*1.0e-5);
-                nstdb_add_em_noise(ecgDenInout, ecgDenInout, ECG_DEN_WINDOW_LEN, (float32_t)appState.emNoiseLevel*1.0e-5);
-            }
+    if (!denEmitting) {
+        denEmitStart = denEmitIdx = denStreamIdx + stage->padLen;
+        denEmitting = true;
+    }
+    // Windows are hop apart- each is read in place
+    for (uint32_t w = 0; w < numWindows; w++) {
+        emitOff = w ? stage->padLen : denEmitIdx - denStreamIdx;
+        emitLen = stage->windowLen - stage->padLen - emitOff;
+        err |= denoise_window(ringbuffer_view_at(&rbEcgDen, w * stage->hopLen, stage->windowLen), stage->padLen, emitOff);
+        ringbuffer_f32_to_q15(&ecgDenInout[emitOff], &ecgDenBatchOut[outLen], emitLen, ECG_Q15_SCALE);
+        outLen += emitLen;
+    }
 
-            // Copy noisy signal to seg buffer
-            ringbuffer_push(&rbEcgRawSeg, &ecgDenInout[ECG_DEN_PAD_LEN], ECG_DEN_VALID_LEN);
+    // Publish clean batch at once so segmentation also takes it as one batch
+    ringbuffer_push(&rbEcgSeg, ecgDenBatchOut, outLen);
+    latency_hist_record(
+        &latencyHists[LatencyPointDenoise], &ecgLatClock,
+        denEmitIdx, outLen,
+        ns_us_ticker_read(&timerCfg)
+    );
+    denEmitIdx += outLen;
 
-            // Apply biquad filter for DSP and AI modes
-            if (appState.denoiseMode == DenoiseModeDsp) {
-                err = pk_apply_biquad_filtfilt_f32(&ecgFilterCtx, ecgDenInout, ecgDenInout, ECG_DEN_WINDOW_LEN, ecgDenScratch);
-            }
-            // Denoise using AI model
-            else if (appState.denoiseMode == DenoiseModeAi) {
-                err = ecg_denoise_inference(&ecgDenModelCtx, ecgDenInout, ecgDenInout, 0, ECG_DEN_THRESHOLD);
-            } else {
-                err = 0;
-            }
+    deltaUs = ns_us_ticker_read(&timerCfg) - tickUs;
+    appMetResults.denoiseIps = 1000000.0*numWindows/deltaUs;
+    ns_lp_printf("<DENOISE Time: %d (n=%d, err=%d) >\n", deltaUs/1000, numWindows, err);
+}
 
-            // Compute cosine similarity
-            if (sensorCtx.inputSource < NUM_INPUT_PTS) {
-                cosine_similarity_f32(
-                    &ecgDenInout[ECG_DEN_PAD_LEN],
-                    &ecgDenNoise[ECG_DEN_PAD_LEN],
-                    ECG_DEN_VALID_LEN,
-                    &appMetResults.denoiseCossim
-                );
-            // Skip for live sensor mode
-            } else {
-                appMetResults.denoiseCossim = 1.0;
-            }
-            appMetResults.denoiseCossim *= 100.0;
+/**
+ * @brief Segment a single window and publish [emitOff, window - pad)
+ *
+ * @param ecgSegWin q15 window (ECG_Q15_SCALE)
+ * @param padLen Context on each side of valid region
+ * @param emitOff Window offset of first emitted sample
+ * @return uint32_t Error code
+ */
+uint32_t segmentation_window(const q15_t *ecgSegWin, uint32_t padLen, uint32_t emitOff) {
+    uint32_t emitLen = ECG_SEG_WINDOW_LEN - padLen - emitOff;
+    uint32_t err = 0;
 
-            // Copy clean signal to seg buffer
-            ringbuffer_push(&rbEcgSeg, &ecgDenInout[ECG_DEN_PAD_LEN], ECG_DEN_VALID_LEN);
+    // Convert q15 window for DSP/model
+    ringbuffer_q15_to_f32(ecgSegWin, ecgSegInout, ECG_SEG_WINDOW_LEN, ECG_Q15_SCALE);
 
-            // Seek ringbuffers
-            ringbuffer_seek(&rbEcgDen, ECG_DEN_VALID_LEN);
-            deltaUs = ns_us_ticker_read(&timerCfg) - tickUs;
-            appMetResults.denoiseIps = 1000000.0/deltaUs;
-            ns_lp_printf("<DENOISE Time: %d (err=%d) >\n", deltaUs/1000, err);
+    if (appState.segMode == SegmentationModeDsp) {
+        err = ecg_physiokit_segmentation_inference(ecgSegInout, ecgSegMask, 0);
+    } else if (appState.segMode == SegmentationModeAi) {
+        err = ecg_segmentation_inference(&ecgSegModelCtx, ecgSegInout, ecgSegMask, 0, ECG_SEG_THRESHOLD);
+    } else{
+        err = 0;
+        for (size_t i = 0; i < ECG_SEG_WINDOW_LEN; i++) {
+            ecgSegMask[i] = ECG_SEG_NONE;
         }
+    }
 
-        ///////////////////////////////////////////////
-        // SEGMENTATION BLOCK
-        ///////////////////////////////////////////////
-        else if (ringbuffer_len(&rbEcgSeg) >= ECG_SEG_WINDOW_LEN) {
-            tickUs = ns_us_ticker_read(&timerCfg);
-            ringbuffer_peek(&rbEcgSeg, ecgSegInout, ECG_SEG_WINDOW_LEN);
-
-            // pk_standardize_f32(ecgSegInout, ecgSegInout, ECG_SEG_WINDOW_LEN, NORM_STD_EPS);
-
-            if (appState.segMode == SegmentationModeDsp) {
-                err = ecg_physiokit_segmentation_inference(ecgSegInout, ecgSegMask, 0);
-            } else if (appState.segMode == SegmentationModeAi) {
-                err = ecg_segmentation_inference(&ecgSegModelCtx, ecgSegInout, ecgSegMask, 0, ECG_SEG_THRESHOLD);
-            } else{
-                err = 0;
-                for (size_t i = 0; i < ECG_SEG_WINDOW_LEN; i++) {
-                    ecgSegMask[i] = ECG_SEG_NONE;
-                }
-            }
+    // Publish raw, den and mask frames once for metrics and Tx
+    push_slot0_frames(&ecgSegWin[emitOff], &ecgSegMask[emitOff], emitLen);
+    return err;
+}
 
-            // Push seg mask to Tx
-            ringbuffer_transfer(&rbEcgRawSeg, &rbEcgRawTx, ECG_SEG_VALID_LEN);
-            ringbuffer_push(&rbEcgDenTx, &ecgSegInout[ECG_SEG_PAD_LEN], ECG_SEG_VALID_LEN);
-            ringbuffer_push(&rbEcgMaskTx, &ecgSegMask[ECG_SEG_PAD_LEN], ECG_SEG_VALID_LEN);
+/**
+ * @brief Segmentation stage: rbEcgSeg (+ rbEcgRawSeg) -> rbEcgSegOut
+ * A backlog is processed as a batch of up to ECG_SEG_MAX_BATCH windows.
+ * The first window emits from segEmitIdx (see denoise_stage_run).
+ *
+ * @param stage Pipeline stage (current pad/hop)
+ * @param numWindows Number of windows (hop apart) at input tail
+ */
+void segmentation_stage_run(const pipeline_stage_t *stage, uint32_t numWindows) {
+    uint32_t err = 0;
+    uint32_t tickUs = ns_us_ticker_read(&timerCfg);
+    uint32_t deltaUs, emitOff, outLen = 0;
 
-            // Push ecg and mask to metrics
-            ringbuffer_push(&rbEcgMet, &ecgSegInout[ECG_SEG_PAD_LEN], ECG_SEG_VALID_LEN);
-            ringbuffer_push(&rbEcgMaskMet, &ecgSegMask[ECG_SEG_PAD_LEN], ECG_SEG_VALID_LEN);
+    if (!segEmitting) {
+        segEmitStart = segEmitIdx = segStreamIdx + stage->padLen;
+        segEmitting = true;
+    }
+    // Read q15 windows (hop apart) in place
+    for (uint32_t w = 0; w < numWindows; w++) {
+        emitOff = w ? stage->padLen : segEmitIdx - segStreamIdx;
+        err |= segmentation_window(ringbuffer_view_at(&rbEcgSeg, w * stage->hopLen, stage->windowLen), stage->padLen, emitOff);
+        outLen += stage->windowLen - stage->padLen - emitOff;
+    }
 
-            ringbuffer_seek(&rbEcgSeg, ECG_SEG_VALID_LEN);
-            deltaUs = ns_us_ticker_read(&timerCfg) - tickUs;
-            appMetResults.segmentIps = 1000000.0/deltaUs;
-            ns_lp_printf("<SEGMENT Time: %d (err=%d) >\n", deltaUs/1000, err);
+    latency_hist_record(
+        &latencyHists[LatencyPointSegment], &ecgLatClock,
+        segEmitIdx + denEmitStart, outLen,
+        ns_us_ticker_read(&timerCfg)
+    );
+    segEmitIdx += outLen;
+
+    deltaUs = ns_us_ticker_read(&timerCfg) - tickUs;
+    appMetResults.segmentIps = 1000000.0*numWindows/deltaUs;
+    ns_lp_printf("<SEGMENT Time: %d (n=%d, err=%d) >\n", deltaUs/1000, numWindows, err);
+}
+
+/**
+ * @brief Split metrics window out of rbEcgSegOut frames
+ * Den is converted to float for DSP/model and mask copied to ecgMetMask.
+ *
+ */
+void read_metrics_window() {
+    tio_ecg_frame_t frames[TIO_SLOT0_FRAMES_PER_PKT];
+    q15_t ecgDen[TIO_SLOT0_FRAMES_PER_PKT];
+    size_t n;
+    for (size_t i = 0; i < ECG_MET_WINDOW_LEN; i += n) {
+        n = ringbuffer_peek_at(&rbEcgSegOut, EcgReaderMet, i, frames, MIN(ECG_MET_WINDOW_LEN - i, TIO_SLOT0_FRAMES_PER_PKT));
+        if (n == 0) { break; }
+        for (size_t j = 0; j < n; j++) {
+            ecgDen[j] = frames[j].den;
+            ecgMetMask[i + j] = (uint16_t)frames[j].mask;
         }
+        ringbuffer_q15_to_f32(ecgDen, &ecgMetInout[i], n, ECG_Q15_SCALE);
+    }
+}
 
-        ///////////////////////////////////////////////
-        // ARRHYTHMIA/METRICS BLOCK
-        ///////////////////////////////////////////////
-        else if (MIN(ringbuffer_len(&rbEcgMet), ringbuffer_len(&rbEcgMaskMet)) >= ECG_MET_WINDOW_LEN) {
-            tickUs = ns_us_ticker_read(&timerCfg);
-
-            // Grab data from ringbuffers
-            ringbuffer_peek(&rbEcgMet, ecgMetData, ECG_MET_WINDOW_LEN);
-            ringbuffer_peek(&rbEcgMaskMet, ecgMaskMetData, ECG_MET_WINDOW_LEN);
-
-            // Compute metrics
-            err = metrics_capture_ecg(
-                &metricsCfg,
-                ecgMetData, ecgMaskMetData, ECG_MET_WINDOW_LEN,
-                &appMetResults
-            );
-
-            if (appState.arrMode == ArrhythmiaModeDsp) {
-                appMetResults.arrhythmiaLabel = appMetResults.hr < 40 ? ECG_ARR_SB : appMetResults.hr > 100 ? ECG_ARR_GSVT : ECG_ARR_SR;
-                ns_lp_printf("HR: %f\n", appMetResults.hr);
-            } else if (appState.arrMode == ArrhythmiaModeAi) {
-                appMetResults.arrhythmiaLabel = ecg_arrhythmia_inference(&ecgArrModelCtx, ecgMetData, ECG_ARR_THRESHOLD);
-            } else {
-                appMetResults.arrhythmiaLabel = 0;
-            }
-            deltaUs = ns_us_ticker_read(&timerCfg) - tickUs;
-            appMetResults.arrhythmiaIps = 1000000.0/deltaUs;
+/**
+ * @brief Metrics stage: rbEcgSegOut (EcgReaderMet) -> Tileio
+ *
+ * @param stage Pipeline stage
+ * @param numWindows Number of windows (always 1)
+ */
+void metrics_stage_run(const pipeline_stage_t *stage, uint32_t numWindows) {
+    uint32_t err = 0;
+    uint32_t tickUs = ns_us_ticker_read(&timerCfg);
+    uint32_t deltaUs;
 
-            appMetResults.cpuPercUtil = 100.0*cpuBusyMs/(cpuBusyMs + cpuIdleMs);
-            cpuBusyMs = 0;
-            cpuIdleMs = 0;
+    read_metrics_window();
 
-            // Store metrics
-            ringbuffer_seek(&rbEcgMet, ECG_MET_VALID_LEN);
-            ringbuffer_seek(&rbEcgMaskMet, ECG_MET_VALID_LEN);
+    // Compute metrics
+    err = metrics_capture_ecg(
+        &metricsCfg,
+        ecgMetInout, ecgMetMask, ECG_MET_WINDOW_LEN,
+        &appMetResults
+    );
 
-            // Broadcast metrics
-            send_slot0_metrics();
-            send_uio_state();
-            ns_lp_printf("<METRICS Time: %d (err=%d) >\n", deltaUs/1000, err);
+    if (appState.arrMode == ArrhythmiaModeDsp) {
+        appMetResults.arrhythmiaLabel = appMetResults.hr < 40 ? ECG_ARR_SB : appMetResults.hr > 100 ? ECG_ARR_GSVT : ECG_ARR_SR;
+        ns_lp_printf("HR: %f\n", appMetResults.hr);
+    } else if (appState.arrMode == ArrhythmiaModeAi) {
+        appMetResults.arrhythmiaLabel = ecg_arrhythmia_inference(&ecgArrModelCtx, ecgMetInout, ECG_ARR_THRESHOLD);
+    } else {
+        appMetResults.arrhythmiaLabel = 0;
+    }
+    deltaUs = ns_us_ticker_read(&timerCfg) - tickUs;
+    appMetResults.arrhythmiaIps = 1000000.0/deltaUs;
+
+    // Broadcast metrics
+    request_tx(TxRequestMetrics);
+    ns_lp_printf("<METRICS Time: %d (err=%d) >\n", deltaUs/1000, err);
+#if (INCLUDE_uxTaskGetStackHighWaterMark == 1) || (configCHECK_FOR_STACK_OVERFLOW > 1)
+    print_stack_watermarks();
+#endif
+}
+
+size_t denoise_stage_available() { return ringbuffer_len(&rbEcgDen); }
+void denoise_stage_consume(size_t len) { denStreamIdx += ringbuffer_seek(&rbEcgDen, len); }
+void denoise_stage_wait(size_t len) { ringbuffer_wait(&rbEcgDen, len, portMAX_DELAY); }
+
+size_t segmentation_stage_available() { return ringbuffer_len(&rbEcgSeg); }
+void segmentation_stage_consume(size_t len) { segStreamIdx += ringbuffer_seek(&rbEcgSeg, len); }
+void segmentation_stage_wait(size_t len) { ringbuffer_wait(&rbEcgSeg, len, portMAX_DELAY); }
+
+size_t metrics_stage_available() { return ringbuffer_len(&rbEcgSegOut, EcgReaderMet); }
+void metrics_stage_consume(size_t len) { ringbuffer_seek(&rbEcgSegOut, EcgReaderMet, len); }
+void metrics_stage_wait(size_t len) { ringbuffer_wait(&rbEcgSegOut, EcgReaderMet, len, portMAX_DELAY); }
+
+// Segmentation also pops rbEcgRawSeg in step with rbEcgSeg (both written by denoise)
+// Pad/hop start at defaults and track appState (see update_stage_hop)
+static pipeline_stage_t processStages[PipelineNumStages] = {
+    {
+        .name = "denoise",
+        .inputRing = PipelineRingEcgDen,
+        .outputRings = (1 << PipelineRingEcgRawSeg) | (1 << PipelineRingEcgSeg),
+        .windowLen = ECG_DEN_WINDOW_LEN,
+        .padLen = ECG_DEN_PAD_LEN,
+        .hopLen = ECG_DEN_VALID_LEN,
+        .maxBatch = ECG_DEN_MAX_BATCH,
+        .available = denoise_stage_available,
+        .run = denoise_stage_run,
+        .consume = denoise_stage_consume,
+        .wait = denoise_stage_wait,
+    },
+    {
+        .name = "segmentation",
+        .inputRing = PipelineRingEcgSeg,
+        .outputRings = (1 << PipelineRingEcgSegOut),
+        .windowLen = ECG_SEG_WINDOW_LEN,
+        .padLen = ECG_SEG_PAD_LEN,
+        .hopLen = ECG_SEG_VALID_LEN,
+        .maxBatch = ECG_SEG_MAX_BATCH,
+        .available = segmentation_stage_available,
+        .run = segmentation_stage_run,
+        .consume = segmentation_stage_consume,
+        .wait = segmentation_stage_wait,
+    },
+    {
+        .name = "metrics",
+        .inputRing = PipelineRingEcgSegOut,
+        .outputRings = 0,
+        .windowLen = ECG_MET_WINDOW_LEN,
+        .padLen = 0,
+        .hopLen = ECG_MET_VALID_LEN,
+        .maxBatch = 1,
+        .available = metrics_stage_available,
+        .run = metrics_stage_run,
+        .consume = metrics_stage_consume,
+        .wait = metrics_stage_wait,
+    },
+};
+
+// Validates stage dataflow at init- each stage is driven by its own StageTask
+pipeline_context_t processPipeline = {
+    .stages = processStages,
+    .numStages = PipelineNumStages,
+    .order = {},
+};
+
+// Effective mode of each stage (written by governor)
+static uint8_t *stageModes[PipelineNumStages] = {
+    &appState.denoiseMode,
+    &appState.segMode,
+    &appState.arrMode
+};
+
+#if defined(TFLM_MODEL_SLOT)
+// Model run by each stage (AI mode)
+static tf_model_context_t *stageModels[PipelineNumStages] = {
+    &ecgDenModelCtx,
+    &ecgSegModelCtx,
+    &ecgArrModelCtx
+};
+#endif
+
+/**
+ * @brief Step stage mode down/up based on input backlog and run latency
+ * Mode changes are reported to the dashboard via UIO state.
+ *
+ * @param idx Pipeline stage index
+ * @param latencyUs Duration of last run
+ */
+void govern_stage(uint32_t idx, uint32_t latencyUs) {
+    const pipeline_stage_t *stage = &processStages[idx];
+    size_t len = stage->available();
+    uint32_t backlog = len >= stage->windowLen ? (len - stage->windowLen)/stage->hopLen + 1 : 0;
+    if (governor_update(&stageGovernors[idx], backlog, latencyUs)) {
+        *stageModes[idx] = stageGovernors[idx].mode;
+        ns_lp_printf("<GOVERNOR %s mode=%d backlog=%d >\n", stage->name, stageGovernors[idx].mode, backlog);
+        request_tx(TxRequestUio);
+    }
+}
+
+/**
+ * @brief Apply mode requested over UIO to stage
+ * Only the task driving the stage calls this (between runs) so the governor
+ * has a single writer and a run always sees one mode.
+ *
+ * @param idx Pipeline stage index
+ */
+void update_stage_mode(uint32_t idx) {
+    uint8_t mode = stageModeRequests[idx].exchange(StageModeNone, std::memory_order_acquire);
+    if (mode == StageModeNone || !governor_request_mode(&stageGovernors[idx], mode)) { return; }
+    *stageModes[idx] = mode;
+    ns_lp_printf("<MODE %s mode=%d >\n", processStages[idx].name, mode);
+    request_tx(TxRequestUio);
+}
+
+/**
+ * @brief Apply pad/hop requested over UIO to stage
+ * Only the task driving the stage calls this (between runs) so a run
+ * always sees one pad/hop. Run latency budget follows the hop.
+ *
+ * @param idx Pipeline stage index
+ */
+void update_stage_hop(uint32_t idx) {
+    pipeline_stage_t *stage = &processStages[idx];
+    uint32_t padLen, hopLen;
+    if (idx == PipelineStageMetrics) {
+        hopLen = appState.metHop * ECG_MET_HOP_UNIT_LEN;
+        padLen = 0;
+    } else {
+        padLen = idx == PipelineStageDenoise ? appState.denPadLen : appState.segPadLen;
+        hopLen = stage->windowLen - 2 * padLen;
+    }
+    if (hopLen == stage->hopLen) { return; }
+    stage->padLen = padLen;
+    stage->hopLen = hopLen;
+    stageGovernors[idx].degradeUs = GOV_HOP_BUDGET_US(hopLen);
+    ns_lp_printf("<HOP %s pad=%d hop=%d >\n", stage->name, padLen, hopLen);
+}
+
+#if defined(TFLM_MODEL_SLOT)
+/**
+ * @brief Apply model swap requested over Tileio to stage
+ * Only the task driving the stage calls this (between runs). A model that
+ * fails to load falls back to the built-in one.
+ *
+ * @param idx Pipeline stage index
+ */
+void update_stage_model(uint32_t idx) {
+    tf_model_context_t *ctx = stageModels[idx];
+    uint32_t request = stageModelRequests[idx].exchange(0, std::memory_order_acquire);
+    uint32_t err, tickUs;
+    if (request == 0) { return; }
+    tickUs = ns_us_ticker_read(&timerCfg);
+    // Other stages' activations share the arena
+    tflm_arena_lock();
+    if ((request & ModelRequestLoad) && modelSlot.state == ModelSlotReady) {
+        err = tflm_model_load(ctx, modelSlot.buffer);
+        if (!err) {
+            modelSlot.state = ModelSlotInUse;
         }
+        ns_lp_printf("<MODEL %s slot load %s (%d bytes, %d us) >\n", processStages[idx].name,
+            err ? "failed" : "ok", modelSlot.len, ns_us_ticker_read(&timerCfg) - tickUs);
+    } else {
+        // Revert only applies to the stage running the slot model
+        err = (request & ModelRequestRevert) && modelSlot.state == ModelSlotInUse && modelSlot.stage == idx;
+    }
+    if (err) {
+        err = tflm_model_load(ctx, ctx->buffer);
+        modelSlot.state = ModelSlotEmpty;
+        ns_lp_printf("<MODEL %s built-in load %s >\n", processStages[idx].name, err ? "failed" : "ok");
+    }
+    tflm_arena_unlock();
+}
+#endif
 
-        // Send slot0 signals
-        send_slot0_signals();
+/**
+ * @brief Run one pipeline stage whenever its input holds a full window
+ * Backlogged windows are taken as one batch. Each stage has its own task
+ * so a long model invoke only delays lower (or equal, see DEN_TASK_PRIORITY)
+ * priority stages.
+ *
+ * @param pvParameters Pipeline stage (const pipeline_stage_t *)
+ */
+void StageTask(void *pvParameters) {
+    const pipeline_stage_t *stage = (const pipeline_stage_t *)pvParameters;
+    uint32_t idx = stage - processStages;
+    uint32_t tickUs, deltaUs, numWindows;
+    while (true) {
+        update_stage_mode(idx);
+        update_stage_hop(idx);
+#if defined(TFLM_MODEL_SLOT)
+        update_stage_model(idx);
+#endif
+        tickUs = ns_us_ticker_read(&timerCfg);
+        // One run (up to maxBatch windows) at a time so governor sees every run
+        numWindows = pipeline_run_stage(stage, 1);
+        if (numWindows) {
+            deltaUs = ns_us_ticker_read(&timerCfg) - tickUs;
+#if !defined(CPU_STATS)
+            stageBusyUs.fetch_add(deltaUs, std::memory_order_relaxed);
+#endif
+            // Budget is per window- a catch-up batch alone is not falling behind
+            govern_stage(idx, deltaUs / numWindows);
+        } else {
+            stage->wait(stage->windowLen);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////
+// TX TASK BLOCK
+////////////////////////////////////////////////////////////////
 
-        // Try to maintain 100ms loop to not back up Tileio
-        deltaUs = ns_us_ticker_read(&timerCfg);
-        cpuBusyMs += deltaUs/1000;
-        if (deltaUs < 100000) {
-            delayUs = 100000 - deltaUs;
-            cpuIdleMs += delayUs/1000;
-            vTaskDelay(pdMS_TO_TICKS(delayUs/1000));
+void TxTask(void *pvParameters) {
+    uint32_t requests;
+    while (true) {
+        // Sleep until segmentation publishes frames or a record is requested
+        if (!rbEcgSegOut.arm(EcgReaderTx, 1) && txRequests.load(std::memory_order_acquire) == 0) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        send_slot0_signals();
+        requests = txRequests.exchange(0, std::memory_order_acquire);
+        if (requests & TxRequestMetrics) {
+            send_cpu_stats();
+            send_slot0_metrics();
+#if defined(TFLM_PROFILE)
+            send_op_profile();
+#else
+            send_ring_stats();
+#endif
+            send_latency_stats();
         }
+#if defined(TFLM_PROFILE)
+        if (requests & TxRequestOpProfile) {
+            dump_op_profile();
+        }
+#endif
+        if (requests & (TxRequestMetrics | TxRequestUio)) {
+            send_uio_state();
+        }
+        // Pace packets to not back up Tileio
+        vTaskDelay(pdMS_TO_TICKS(TIO_SLOT0_TX_PERIOD_MS));
     }
 }
 
@@ -470,42 +1098,280 @@ void setup_task(void *pvParameters) {
     tio_start(&tioCtx);
     xTaskCreate(TioTask, "TioTask", 512, NULL, 3, &tioTaskHandle);
     xTaskCreate(SensorTask, "SensorTask", 512, 0, 3, &sensorTaskHandle);
-    xTaskCreate(ProcessTask, "ProcessTask", 3072, 0, 1, &processTaskHandle);
-    send_uio_state();
+    xTaskCreate(TxTask, "TxTask", TX_TASK_STACK_LEN, 0, TX_TASK_PRIORITY, &txTaskHandle);
+    xTaskCreate(StageTask, "SegTask", SEG_TASK_STACK_LEN, (void *)&processStages[PipelineStageSegmentation], SEG_TASK_PRIORITY, &segmentationTaskHandle);
+    xTaskCreate(StageTask, "DenTask", DEN_TASK_STACK_LEN, (void *)&processStages[PipelineStageDenoise], DEN_TASK_PRIORITY, &denoiseTaskHandle);
+    xTaskCreate(StageTask, "MetTask", MET_TASK_STACK_LEN, (void *)&processStages[PipelineStageMetrics], MET_TASK_PRIORITY, &metricsTaskHandle);
+#if defined(CPU_STATS)
+    cpu_stats_register(&cpuStats, CpuTaskSensor, sensorTaskHandle);
+    cpu_stats_register(&cpuStats, CpuTaskDenoise, denoiseTaskHandle);
+    cpu_stats_register(&cpuStats, CpuTaskSegmentation, segmentationTaskHandle);
+    cpu_stats_register(&cpuStats, CpuTaskMetrics, metricsTaskHandle);
+    cpu_stats_register(&cpuStats, CpuTaskTx, txTaskHandle);
+    cpu_stats_register(&cpuStats, CpuTaskTio, tioTaskHandle);
+#if (INCLUDE_xTaskGetIdleTaskHandle == 1)
+    cpu_stats_register_idle(&cpuStats, xTaskGetIdleTaskHandle());
+#endif
+#endif
+    // New tasks run at or below this priority so waiters are set before first wait
+    rbEcgDen.set_waiter(denoiseTaskHandle);
+    rbEcgSeg.set_waiter(segmentationTaskHandle);
+    rbEcgSegOut.set_waiter(EcgReaderMet, metricsTaskHandle);
+    rbEcgSegOut.set_waiter(EcgReaderTx, txTaskHandle);
+    request_tx(TxRequestUio);
     vTaskSuspend(NULL);
     while (1) { };
 }
 
+#if defined(HEARTKIT_HOST)
+
+////////////////////////////////////////////////////////////////
+// HOST REPLAY BLOCK
+////////////////////////////////////////////////////////////////
+
+// External record replayed in place of stimulus (ECG slot at SENSOR_RATE, ecg_stimulus units)
+static int32_t *hostRecord = NULL;
+static size_t hostRecordLen = 0, hostRecordIdx = 0;
+
+/**
+ * @brief Load external record (one sample per line)
+ *
+ * @param path Record file path
+ * @return uint32_t 0 on success
+ */
+uint32_t
+host_load_record(const char *path) {
+    FILE *fp = fopen(path, "r");
+    size_t cap = 0;
+    long val;
+    if (fp == NULL) { return 1; }
+    while (fscanf(fp, "%ld", &val) == 1) {
+        if (hostRecordLen == cap) {
+            cap = cap ? 2 * cap : 4096;
+            hostRecord = (int32_t *)realloc(hostRecord, cap * sizeof(int32_t));
+            if (hostRecord == NULL) { fclose(fp); return 1; }
+        }
+        hostRecord[hostRecordLen++] = (int32_t)val;
+    }
+    fclose(fp);
+    return hostRecordLen == 0;
+}
+
+/**
+ * @brief Fill sensor buffer from external record (loops at end)
+ *
+ * @param reqSamples Number of samples
+ * @return uint32_t Number of samples
+ */
+uint32_t
+host_record_data(uint32_t reqSamples) {
+    size_t idx;
+    for (size_t i = 0; i < reqSamples; i++) {
+        for (size_t j = 0; j < sensorCtx.maxCfg->numSlots; j++) {
+            idx = sensorCtx.maxCfg->numSlots * i + j;
+            sensorCtx.buffer[idx] = sensorCtx.maxCfg->fifoSlotConfigs[j] == Max86150SlotEcg ? hostRecord[hostRecordIdx] : 0;
+        }
+        hostRecordIdx = (hostRecordIdx + 1) % hostRecordLen;
+    }
+    return reqSamples;
+}
+
+/**
+ * @brief Host replay driver
+ * Replays stimulus (or an external record) through the pipeline as fast as
+ * possible from a plain loop in place of the RTOS tasks. Stages run in
+ * dataflow order after every sensor read and the governor is left out so
+ * modes stay fixed. Reports throughput per stage and end to end.
+ * Tx frames and metrics runs can be recorded as a golden file (-o) or
+ * checked against one (-c, exits 1 when out of tolerance).
+ *
+ * Usage: heartkit [-s seconds] [-i input] [-d den] [-g seg] [-a arr] [-n bw,ma,em] [-p den,seg,met] [-r record] [-o|-c golden] [-v]
+ * where -p takes the UIO pad/hop values (TIO_UIO_*_PAD_IDX, TIO_UIO_MET_HOP_IDX).
+ *
+ */
+int main(int argc, char *argv[]) {
+    uint64_t stageUs[PipelineNumStages] = {0};
+    uint32_t stageWindows[PipelineNumStages] = {0};
+    uint64_t totalSamples = 0, numSamples = 0, wallUs;
+    uint32_t startUs, tickUs, idx, n, numWindows;
+    unsigned int bw = 0, ma = 0, em = 0;
+    unsigned int denPad = appState.denPadLen, segPad = appState.segPadLen, metHop = appState.metHop;
+    const pipeline_stage_t *stage;
+    float64_t samplesPerSec;
+    tio_ecg_frame_t frames[TIO_SLOT0_FRAMES_PER_PKT];
+    size_t numFrames;
+    golden_context_t golden = {};
+    const char *goldenPath = NULL;
+    uint32_t goldenCheck = 0;
+    char goldenHeader[128];
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:i:d:g:a:n:p:r:o:c:v")) != -1) {
+        switch (opt) {
+        case 's': totalSamples = (uint64_t)atoi(optarg) * SENSOR_RATE; break;
+        // Live sensor source is not available on host
+        case 'i': appState.inputSource = MIN(atoi(optarg), NUM_INPUT_PTS - 1); break;
+        case 'd': appState.denoiseMode = MIN(atoi(optarg), 2); break;
+        case 'g': appState.segMode = MIN(atoi(optarg), 2); break;
+        case 'a': appState.arrMode = MIN(atoi(optarg), 2); break;
+        case 'n':
+            sscanf(optarg, "%u,%u,%u", &bw, &ma, &em);
+            appState.bwNoiseLevel = MIN(bw, 99);
+            appState.maNoiseLevel = MIN(ma, 99);
+            appState.emNoiseLevel = MIN(em, 99);
+            break;
+        case 'p':
+            sscanf(optarg, "%u,%u,%u", &denPad, &segPad, &metHop);
+            set_stage_hops(MIN(denPad, 255), MIN(segPad, 255), MIN(metHop, 255));
+            break;
+        case 'r':
+            if (host_load_record(optarg)) {
+                printf("Failed to load record %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 'o': goldenPath = optarg; goldenCheck = 0; break;
+        case 'c': goldenPath = optarg; goldenCheck = 1; break;
+        case 'v': host_verbose = true; break;
+        default:
+            printf("Usage: %s [-s seconds] [-i input] [-d den] [-g seg] [-a arr] [-n bw,ma,em] [-p den,seg,met] [-r record] [-o|-c golden] [-v]\n", argv[0]);
+            return 1;
+        }
+    }
+    // Default to one pass of the input
+    if (totalSamples == 0) {
+        totalSamples = hostRecordLen ? hostRecordLen : ecg_stimulus_len;
+    }
+    sensorCtx.inputSource = appState.inputSource;
+    if (goldenPath != NULL) {
+        snprintf(goldenHeader, sizeof(goldenHeader),
+            "input=%d noise=%d,%d,%d den=%d seg=%d arr=%d pad=%d,%d,%d samples=%llu",
+            appState.inputSource, appState.bwNoiseLevel, appState.maNoiseLevel, appState.emNoiseLevel,
+            appState.denoiseMode, appState.segMode, appState.arrMode,
+            appState.denPadLen, appState.segPadLen, appState.metHop, (unsigned long long)totalSamples
+        );
+        if (golden_open(&golden, goldenPath, goldenCheck, goldenHeader)) {
+            printf("Failed to open golden %s\n", goldenPath);
+            return 1;
+        }
+    }
+
+    NS_TRY(ns_timer_init(&timerCfg), "Timer Init failed.\n");
+    NS_TRY(tflm_init(), "TFLM Init Failed\n");
+    NS_TRY(tflm_model_load(&ecgDenModelCtx, ecgDenModelCtx.buffer), "ECG Denoise Init Failed\n");
+    NS_TRY(tflm_model_load(&ecgSegModelCtx, ecgSegModelCtx.buffer), "ECG Segmentation Init Failed\n");
+    NS_TRY(tflm_model_load(&ecgArrModelCtx, ecgArrModelCtx.buffer), "ECG Arrhythmia Init Failed\n");
+    NS_TRY(metrics_init(&metricsCfg), "Metrics Init Failed\n");
+    NS_TRY(pipeline_init(&processPipeline), "Pipeline Init Failed\n");
+    for (uint32_t i = 0; i < PipelineNumStages; i++) {
+        governor_set_mode(&stageGovernors[i], *stageModes[i]);
+        stageModeRequests[i].store(StageModeNone, std::memory_order_relaxed);
+    }
+
+    startUs = ns_us_ticker_read(&timerCfg);
+    while (numSamples < totalSamples) {
+        n = MIN(totalSamples - numSamples, SENSOR_NOM_REFRESH_LEN);
+        n = hostRecordLen ? host_record_data(n) : sensor_dummy_data(&sensorCtx, n);
+        extract_sensor_data(n);
+        preprocess_sensor_data();
+        numSamples += n;
+        for (uint32_t i = 0; i < processPipeline.numStages; i++) {
+            stage = processPipeline.order[i];
+            idx = stage - processStages;
+            update_stage_mode(idx);
+            update_stage_hop(idx);
+#if defined(TFLM_MODEL_SLOT)
+            update_stage_model(idx);
+#endif
+            // One run at a time so every metrics run is recorded
+            do {
+                tickUs = ns_us_ticker_read(&timerCfg);
+                numWindows = pipeline_run_stage(stage, 1);
+                stageUs[idx] += ns_us_ticker_read(&timerCfg) - tickUs;
+                stageWindows[idx] += numWindows;
+                if (numWindows && idx == PipelineStageMetrics) {
+                    golden_metrics(&golden, appMetResults.hr, appMetResults.hrv, appMetResults.arrhythmiaLabel);
+                }
+            } while (numWindows);
+        }
+        // Drain Tx as TxTask would (frames go to golden file)
+        while ((numFrames = ringbuffer_pop(&rbEcgSegOut, EcgReaderTx, frames, TIO_SLOT0_FRAMES_PER_PKT)) > 0) {
+            for (size_t j = 0; j < numFrames; j++) {
+                golden_frame(&golden, frames[j].den, (uint16_t)frames[j].mask);
+            }
+        }
+        txRequests.exchange(0, std::memory_order_acquire);
+    }
+    wallUs = ns_us_ticker_read(&timerCfg) - startUs;
+
+    printf("Replayed %llu samples (%.1f s) input=%d den=%d seg=%d arr=%d\n",
+        (unsigned long long)numSamples, (float64_t)numSamples / SENSOR_RATE,
+        appState.inputSource, appState.denoiseMode, appState.segMode, appState.arrMode
+    );
+    printf("%-14s %6s %8s %10s %10s %12s %10s\n", "stage", "hop", "windows", "busy ms", "us/window", "samples/s", "x realtime");
+    for (uint32_t i = 0; i < PipelineNumStages; i++) {
+        stage = &processStages[i];
+        samplesPerSec = stageUs[i] ? 1e6 * stageWindows[i] * stage->hopLen / stageUs[i] : 0;
+        printf("%-14s %6u %8u %10.1f %10.1f %12.0f %10.1f\n",
+            stage->name, stage->hopLen, stageWindows[i], stageUs[i] / 1000.0,
+            stageWindows[i] ? (float64_t)stageUs[i] / stageWindows[i] : 0.0,
+            samplesPerSec, samplesPerSec / ECG_SAMPLE_RATE
+        );
+    }
+    // End to end in ECG samples (after downsampling)
+    samplesPerSec = wallUs ? 1e6 * (numSamples / ECG_DS_RATE) / wallUs : 0;
+    printf("%-14s %6s %8s %10.1f %10s %12.0f %10.1f\n", "total", "", "", wallUs / 1000.0, "", samplesPerSec, samplesPerSec / ECG_SAMPLE_RATE);
+    return golden_close(&golden);
+}
+
+#else
+
 int main(void) {
+    uint32_t tflmInitUs;
 
     sensorCtx.inputSource = appState.inputSource;
     nsPwrCfg.eAIPowerMode = appState.speedMode ? NS_MAXIMUM_PERF : NS_MINIMUM_PERF;
     tioCtx.slot_update_cb = &received_slot_data;
     tioCtx.uio_update_cb = &received_uio_state;
+#if defined(CPU_STATS)
+    timer2Cfg.callback = &sample_running_task;
+#endif
 
     NS_TRY(ns_core_init(&nsCoreCfg), "Core Init failed.\b");
     NS_TRY(ns_power_config(&nsPwrCfg), "Power Init Failed\n");
     NS_TRY(ns_i2c_interface_init(&nsI2cCfg, I2C_SPEED_HZ), "I2C Init Failed\n");
     NS_TRY(ns_timer_init(&timerCfg), "Timer Init failed.\n");
+#if defined(CPU_STATS)
     NS_TRY(ns_timer_init(&timer2Cfg), "Timer 2 Init failed.\n");
+#endif
     NS_TRY(ns_peripheral_button_init(&nsBtnCfg), "Button Init failed.\n");
     am_devices_led_array_init(am_bsp_psLEDs, AM_BSP_NUM_LEDS);
     am_devices_led_array_out(am_bsp_psLEDs, AM_BSP_NUM_LEDS, 0);
     NS_TRY(ledstick_init(&nsI2cCfg, LEDSTICK_ADDR), "Led Stick Init Failed\n");
     NS_TRY(sensor_init(&sensorCtx), "Sensor Init Failed\n");
     NS_TRY(tio_init(&tioCtx), "TIO Init Failed\n");
+    tflmInitUs = ns_us_ticker_read(&timerCfg);
     NS_TRY(tflm_init(), "TFLM Init Failed\n");
-    NS_TRY(ecg_denoise_init(&ecgDenModelCtx), "ECG Segmentation Init Failed\n");
-    NS_TRY(ecg_segmentation_init(&ecgSegModelCtx), "ECG Segmentation Init Failed\n");
-    NS_TRY(ecg_arrhythmia_init(&ecgArrModelCtx), "ECG Arrhythmia Init Failed\n");
+    NS_TRY(tflm_model_load(&ecgDenModelCtx, ecgDenModelCtx.buffer), "ECG Denoise Init Failed\n");
+    NS_TRY(tflm_model_load(&ecgSegModelCtx, ecgSegModelCtx.buffer), "ECG Segmentation Init Failed\n");
+    NS_TRY(tflm_model_load(&ecgArrModelCtx, ecgArrModelCtx.buffer), "ECG Arrhythmia Init Failed\n");
+    tflmInitUs = ns_us_ticker_read(&timerCfg) - tflmInitUs;
     NS_TRY(metrics_init(&metricsCfg), "Metrics Init Failed\n");
+    NS_TRY(pipeline_init(&processPipeline), "Pipeline Init Failed\n");
+    for (uint32_t i = 0; i < PipelineNumStages; i++) {
+        governor_set_mode(&stageGovernors[i], *stageModes[i]);
+        stageModeRequests[i].store(StageModeNone, std::memory_order_relaxed);
+    }
     sensor_start(&sensorCtx);
     // ledstick_set_all_colors(&nsI2cCfg, LEDSTICK_ADDR, 0, 207, 193);
     // ledstick_set_all_brightness(&nsI2cCfg, LEDSTICK_ADDR, 15);
     ns_itm_printf_enable();
+    ns_lp_printf("<BOOT TFLM init: %d us (%d ops) >\n", tflmInitUs, TFLM_NUM_OPS);
     ns_interrupt_master_enable();
 
     xTaskCreate(setup_task, "Setup", 512, 0, 3, &appSetupTask);
     vTaskStartScheduler();
     while (1) { };
 }
+
+#endif // HEARTKIT_HOST
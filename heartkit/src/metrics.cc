@@ -31,12 +31,12 @@ uint32_t
 metrics_capture_ecg(
     metrics_config_t *ctx,
     float32_t *ecg,
-    uint16_t *ecgMask,
+    const uint16_t *ecgMask,
     size_t len,
     metrics_app_results_t *results
 ) {
     uint32_t err = 0;
-    uint16_t peakVal, beatVal;
+    uint16_t peakVal;
     // float32_t badPeakPerc = 0;
     size_t numPPeaks = 0, numQrsPeaks = 0, numTPeaks = 0, numBeats = 0, numNoiseBeats = 0;
     float32_t hr = 0;
@@ -60,17 +60,14 @@ metrics_capture_ecg(
     pk_ecg_filter_rr_intervals(rriMetrics, numQrsPeaks, rriMask, ECG_SAMPLE_RATE, MIN_RR_SEC, MAX_RR_SEC, MIN_RR_DELTA);
     pk_hrv_compute_time_metrics_from_rr_intervals(rriMetrics, numQrsPeaks, rriMask, &ecgHrvMetrics, ECG_SAMPLE_RATE);
 
-    // Annotate mask with beats
+    // Classify beats (mask is read in place from ringbuffer so it is not annotated)
     for (size_t i = 0; i < numQrsPeaks; i++) {
         if (rriMask[i] == 1) {
-            beatVal = ECG_FID_BEAT_NOISE;
             numNoiseBeats += 1;
         } else {
             hr += 60.0f / (rriMetrics[i] / (float32_t)ECG_SAMPLE_RATE);
-            beatVal = ECG_FID_BEAT_NSR;
             numBeats += 1;
         }
-        ecgMask[peaksMetrics[i]] |= ((beatVal & ECG_MASK_FID_BEAT_MASK) << ECG_MASK_FID_BEAT_OFFSET);
     }
     hr /= MAX(1, numBeats);
 
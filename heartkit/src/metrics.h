@@ -59,7 +59,7 @@ uint32_t
 metrics_capture_ecg(
     metrics_config_t *ctx,
     float32_t *ecg,
-    uint16_t *ecgMask,
+    const uint16_t *ecgMask,
     size_t len,
     metrics_app_results_t *results
 );
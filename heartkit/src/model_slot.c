@@ -0,0 +1,73 @@
+/**
+ * @file model_slot.c
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief RAM slot for model flatbuffers received over Tileio
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include <stdint.h>
+#include <string.h>
+#include "model_slot.h"
+
+static inline uint32_t
+read_u16(const uint8_t *data) {
+    return data[0] | (data[1] << 8);
+}
+
+static inline uint32_t
+read_u32(const uint8_t *data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+uint32_t
+model_slot_receive(model_slot_t *ctx, const uint8_t *data, uint32_t length, uint8_t *stage) {
+    uint32_t dlen, value;
+    if (length < MODEL_SLOT_HDR_LEN) {
+        return ModelSlotEventError;
+    }
+    *stage = data[1];
+    dlen = read_u16(&data[2]);
+    value = read_u32(&data[4]);
+    switch (data[0]) {
+    case ModelSlotCmdBegin:
+        // Slot is busy until the stage that owns it reverts
+        if (ctx->state == ModelSlotReady || ctx->state == ModelSlotInUse || value == 0 || value > ctx->size) {
+            return ModelSlotEventError;
+        }
+        ctx->stage = *stage;
+        ctx->len = value;
+        ctx->received = 0;
+        ctx->state = ModelSlotReceiving;
+        return ModelSlotEventNone;
+
+    case ModelSlotCmdData:
+        // Chunks must arrive in order- a rejected chunk can be resent from received
+        if (ctx->state != ModelSlotReceiving || value != ctx->received ||
+            dlen > length - MODEL_SLOT_HDR_LEN || dlen > ctx->len - ctx->received) {
+            return ModelSlotEventError;
+        }
+        memcpy(&ctx->buffer[value], &data[MODEL_SLOT_HDR_LEN], dlen);
+        ctx->received += dlen;
+        return ModelSlotEventNone;
+
+    case ModelSlotCmdCommit:
+        if (ctx->state != ModelSlotReceiving || ctx->received != ctx->len || *stage != ctx->stage) {
+            return ModelSlotEventError;
+        }
+        ctx->state = ModelSlotReady;
+        return ModelSlotEventLoad;
+
+    case ModelSlotCmdRevert:
+        // Also drops a partial transfer
+        if (ctx->state == ModelSlotReceiving) {
+            ctx->state = ModelSlotEmpty;
+        }
+        return ModelSlotEventRevert;
+
+    default:
+        return ModelSlotEventError;
+    }
+}
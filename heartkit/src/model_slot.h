@@ -0,0 +1,83 @@
+/**
+ * @file model_slot.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief RAM slot for model flatbuffers received over Tileio
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __MODEL_SLOT_H
+#define __MODEL_SLOT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define MODEL_SLOT_HDR_LEN (8)
+#define MODEL_SLOT_CHUNK_LEN (232) // 240 byte payload - header
+
+/**
+ * @brief Transfer commands (byte 0 of each slot packet)
+ * Packet header (little endian): cmd (u8), stage (u8), dlen (u16), value (u32)
+ * followed by dlen data bytes. value is the model length for Begin and the
+ * data offset for Data.
+ *
+ */
+enum ModelSlotCmd {
+    ModelSlotCmdBegin,  // Start transfer of value bytes for stage
+    ModelSlotCmdData,   // dlen bytes at offset value (in order)
+    ModelSlotCmdCommit, // Load received model into stage
+    ModelSlotCmdRevert, // Reload stage's built-in model
+};
+typedef enum ModelSlotCmd ModelSlotCmd;
+
+enum ModelSlotState {
+    ModelSlotEmpty,
+    ModelSlotReceiving,
+    ModelSlotReady, // Committed- waiting for stage to load it
+    ModelSlotInUse, // Loaded by stage
+};
+typedef enum ModelSlotState ModelSlotState;
+
+enum ModelSlotEvent { ModelSlotEventNone, ModelSlotEventLoad, ModelSlotEventRevert, ModelSlotEventError };
+typedef enum ModelSlotEvent ModelSlotEvent;
+
+/**
+ * @brief Model RAM slot
+ * The receiver only moves Empty/Receiving -> Receiving/Ready and the stage
+ * only moves Ready/InUse -> InUse/Empty so the two sides never write state
+ * at the same time. A new transfer is refused until the stage releases the
+ * slot (revert).
+ *
+ */
+typedef struct {
+    uint8_t *buffer; // Flatbuffer storage (16 byte aligned)
+    uint32_t size;
+    // State
+    volatile uint8_t state; // ModelSlotState
+    uint8_t stage;          // Target stage of transfer
+    uint32_t len;           // Model length
+    uint32_t received;      // Bytes received
+} model_slot_t;
+
+/**
+ * @brief Handle one transfer packet
+ *
+ * @param ctx Model slot
+ * @param data Packet
+ * @param length Packet length (may include padding after data)
+ * @param stage Target stage of a load or revert event
+ * @return uint32_t ModelSlotEvent
+ */
+uint32_t
+model_slot_receive(model_slot_t *ctx, const uint8_t *data, uint32_t length, uint8_t *stage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __MODEL_SLOT_H
@@ -0,0 +1,62 @@
+/**
+ * @file pipeline.c
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Declarative windowed stage scheduler
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include "pipeline.h"
+
+uint32_t
+pipeline_init(pipeline_context_t *ctx) {
+    uint32_t placed = 0, numPlaced = 0, produced;
+    const pipeline_stage_t *stage;
+    if (ctx->numStages > PIPELINE_MAX_STAGES) { return 1; }
+    for (uint32_t i = 0; i < ctx->numStages; i++) {
+        stage = &ctx->stages[i];
+        if (stage->inputRing >= PIPELINE_MAX_RINGS) { return 1; }
+        if (stage->hopLen == 0 || stage->hopLen > stage->windowLen) { return 1; }
+        if (stage->padLen && stage->hopLen + 2 * stage->padLen != stage->windowLen) { return 1; }
+        if (!stage->available || !stage->run || !stage->consume) { return 1; }
+    }
+    // Kahn's algorithm: place a stage once no unplaced stage writes its input
+    while (numPlaced < ctx->numStages) {
+        uint32_t progress = 0;
+        for (uint32_t i = 0; i < ctx->numStages; i++) {
+            if (placed & (1UL << i)) { continue; }
+            produced = 0;
+            for (uint32_t j = 0; j < ctx->numStages; j++) {
+                if (j != i && !(placed & (1UL << j))) {
+                    produced |= ctx->stages[j].outputRings;
+                }
+            }
+            if (produced & (1UL << ctx->stages[i].inputRing)) { continue; }
+            ctx->order[numPlaced++] = &ctx->stages[i];
+            placed |= 1UL << i;
+            progress = 1;
+        }
+        if (!progress) { return 1; }
+    }
+    return 0;
+}
+
+uint32_t
+pipeline_run_stage(const pipeline_stage_t *stage, uint32_t maxRuns) {
+    uint32_t numRuns = 0, numWindows = 0, batch;
+    size_t len;
+    while ((len = stage->available()) >= stage->windowLen) {
+        // Take every ready window up to maxBatch
+        batch = (len - stage->windowLen) / stage->hopLen + 1;
+        if (batch > stage->maxBatch) { batch = stage->maxBatch ? stage->maxBatch : 1; }
+        stage->run(stage, batch);
+        stage->consume(batch * stage->hopLen);
+        numWindows += batch;
+        if (++numRuns == maxRuns) { break; }
+    }
+    return numWindows;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file pipeline.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Declarative windowed stage scheduler
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __PIPELINE_H
+#define __PIPELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define PIPELINE_MAX_STAGES (8)
+#define PIPELINE_MAX_RINGS (32)
+
+/**
+ * @brief Windowed pipeline stage
+ * A stage runs when its input holds windowLen elements. Each run reads the
+ * window at the input tail, pushes its results to its outputs and then the
+ * scheduler consumes hopLen from the input. padLen is the context on each
+ * side of the hopLen elements a window emits (windowLen == hopLen +
+ * 2 * padLen). Stages that emit per window rather than per element (metrics)
+ * set padLen to 0 and may overlap windows by windowLen - hopLen. When
+ * several windows are ready a run
+ * may take up to maxBatch consecutive windows (hopLen apart) at once. Rings
+ * are identified by id (< PIPELINE_MAX_RINGS) so the scheduler can order
+ * stages by dataflow. padLen and hopLen may be changed between runs by the
+ * task driving the stage.
+ *
+ */
+typedef struct pipeline_stage {
+    const char *name;
+    uint32_t inputRing;     // Ring id read by stage
+    uint32_t outputRings;   // Bitmask of ring ids written by stage
+    uint32_t windowLen;     // Elements required on input to run
+    uint32_t padLen;        // Context elements on each side of hop (0 = not emitted per element)
+    uint32_t hopLen;        // Elements consumed per window (*_VALID_LEN)
+    uint32_t maxBatch;      // Max windows per run (0 = 1)
+    size_t (*available)(void);      // Elements ready on input ring(s)
+    void (*run)(const struct pipeline_stage *stage, uint32_t numWindows); // Process windows at input tail, push outputs
+    void (*consume)(size_t len);    // Advance input ring(s)
+    void (*wait)(size_t len);       // Block until input holds len elements (optional)
+} pipeline_stage_t;
+
+/**
+ * @brief Pipeline context
+ *
+ */
+typedef struct {
+    const pipeline_stage_t *stages;
+    uint32_t numStages;
+    // Internal
+    const pipeline_stage_t *order[PIPELINE_MAX_STAGES];
+} pipeline_context_t;
+
+/**
+ * @brief Validate stages and order them so producers run before consumers
+ * Stages are driven in ctx->order by the host replay.
+ *
+ * @param ctx Pipeline context
+ * @return uint32_t 0 on success, 1 if invalid or stages form a cycle
+ */
+uint32_t
+pipeline_init(pipeline_context_t *ctx);
+
+/**
+ * @brief Run a single stage while its input holds a full window
+ * Used when each stage is driven by its own task.
+ *
+ * @param stage Pipeline stage
+ * @param maxRuns Max runs (0 = drain)
+ * @return uint32_t Number of windows processed
+ */
+uint32_t
+pipeline_run_stage(const pipeline_stage_t *stage, uint32_t maxRuns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __PIPELINE_H
@@ -0,0 +1,90 @@
+/**
+ * @file q15_ringbuffer.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief q15 storage helpers for typed ring buffers
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __Q15_RINGBUFFER_H
+#define __Q15_RINGBUFFER_H
+
+#include "arm_math.h"
+#include "typed_ringbuffer.h"
+
+/**
+ * Signal rings may store q15_t instead of float32_t to halve their RAM. Each
+ * such ring has a fixed scale (units per LSB) defined next to its length in
+ * constants.h: value = q * scale. Samples are converted with saturation on
+ * push and back to float32_t when a stage reads its window.
+ */
+
+#define RINGBUFFER_Q15_CHUNK_LEN (32)
+
+/**
+ * @brief Convert q15 samples to float32 (value = q * scale)
+ *
+ * @param src q15 samples (e.g. from ringbuffer_view)
+ * @param dst Output samples
+ * @param len Number of samples
+ * @param scale Units per LSB
+ */
+static inline void
+ringbuffer_q15_to_f32(const q15_t *src, float32_t *dst, size_t len, float32_t scale) {
+    // arm_q15_to_float yields q / 32768
+    arm_q15_to_float(src, dst, len);
+    arm_scale_f32(dst, scale * 32768.0f, dst, len);
+}
+
+/**
+ * @brief Convert float32 samples to q15 (q = value / scale, saturating)
+ * Converts in chunks so no caller scratch is needed.
+ *
+ * @param src Input samples
+ * @param dst q15 samples
+ * @param len Number of samples
+ * @param scale Units per LSB
+ */
+static inline void
+ringbuffer_f32_to_q15(const float32_t *src, q15_t *dst, size_t len, float32_t scale) {
+    float32_t scratch[RINGBUFFER_Q15_CHUNK_LEN];
+    // arm_float_to_q15 maps [-1, 1) -> q15 so fold scale into the pre-scale
+    const float32_t invScale = 1.0f / (scale * 32768.0f);
+    size_t n;
+    for (size_t i = 0; i < len; i += n) {
+        n = len - i < RINGBUFFER_Q15_CHUNK_LEN ? len - i : RINGBUFFER_Q15_CHUNK_LEN;
+        arm_scale_f32(&src[i], invScale, scratch, n);
+        arm_float_to_q15(scratch, &dst[i], n);
+    }
+}
+
+/**
+ * @brief Convert float32 samples and push to q15 ringbuffer (saturating)
+ * Converts in chunks so no caller scratch is needed. Stops at the first
+ * chunk the ring does not fully accept, so a later chunk never lands behind
+ * a gap (the ring's dropped count then only covers that chunk).
+ *
+ * @param ctx q15 ringbuffer (RingBuffer, WaitableRingBuffer, ...)
+ * @param data Samples to push
+ * @param len Number of samples
+ * @param scale Units per LSB
+ * @return size_t Number of samples pushed
+ */
+template <typename Ring>
+inline size_t
+ringbuffer_push_f32(Ring *ctx, const float32_t *data, size_t len, float32_t scale) {
+    q15_t q15[RINGBUFFER_Q15_CHUNK_LEN];
+    size_t amt = 0, n, pushed;
+    for (size_t i = 0; i < len; i += n) {
+        n = len - i < RINGBUFFER_Q15_CHUNK_LEN ? len - i : RINGBUFFER_Q15_CHUNK_LEN;
+        ringbuffer_f32_to_q15(&data[i], q15, n, scale);
+        pushed = ctx->push(q15, n);
+        amt += pushed;
+        if (pushed < n) { break; }
+    }
+    return amt;
+}
+
+#endif // __Q15_RINGBUFFER_H
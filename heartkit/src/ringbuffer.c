@@ -1,4 +1,3 @@
-
 /**
  * @file ringbuffer.cc
  * @author Adam Page (adam.page@ambiq.com)
@@ -14,6 +13,75 @@
 #include <string.h>
 #include "ringbuffer.h"
 
+/**
+ * @brief Copy elements into ringbuffer starting at index (splits at wrap)
+ *
+ * @param ctx Ringbuffer context
+ * @param idx Start index
+ * @param data Source data
+ * @param len Number of elements
+ * @return uint32_t Index after last written element
+ */
+static inline uint32_t
+ringbuffer_write_at(rb_config_t *ctx, uint32_t idx, const void *data, size_t len) {
+    size_t first = ctx->size - idx;
+    if (first > len) { first = len; }
+    memcpy(((char *)ctx->buffer) + idx * ctx->dlen, data, first * ctx->dlen);
+    if (len > first) {
+        memcpy(ctx->buffer, ((const char *)data) + first * ctx->dlen, (len - first) * ctx->dlen);
+        return len - first;
+    }
+    idx += first;
+    return idx == ctx->size ? 0 : idx;
+}
+
+/**
+ * @brief Copy elements out of ringbuffer starting at index (splits at wrap)
+ *
+ * @param ctx Ringbuffer context
+ * @param idx Start index
+ * @param data Destination buffer
+ * @param len Number of elements
+ * @return uint32_t Index after last read element
+ */
+static inline uint32_t
+ringbuffer_read_at(rb_config_t *ctx, uint32_t idx, void *data, size_t len) {
+    size_t first = ctx->size - idx;
+    if (first > len) { first = len; }
+    memcpy(data, ((char *)ctx->buffer) + idx * ctx->dlen, first * ctx->dlen);
+    if (len > first) {
+        memcpy(((char *)data) + first * ctx->dlen, ctx->buffer, (len - first) * ctx->dlen);
+        return len - first;
+    }
+    idx += first;
+    return idx == ctx->size ? 0 : idx;
+}
+
+static inline uint32_t
+ringbuffer_advance(rb_config_t *ctx, uint32_t idx, size_t len) {
+    idx += len;
+    return idx >= ctx->size ? idx - ctx->size : idx;
+}
+
+/**
+ * @brief Replicate a single element into a contiguous segment using doubling copies
+ *
+ * @param dst Destination segment
+ * @param value Element value
+ * @param len Number of elements
+ * @param dlen Element size
+ */
+static inline void
+ringbuffer_splat(char *dst, const void *value, size_t len, size_t dlen) {
+    size_t n = 1;
+    memcpy(dst, value, dlen);
+    while (n < len) {
+        size_t cnt = n > len - n ? len - n : n;
+        memcpy(dst + n * dlen, dst, cnt * dlen);
+        n += cnt;
+    }
+}
+
 size_t ringbuffer_len(rb_config_t *ctx) {
     if (ctx->head >= ctx->tail) {
         return ctx->head - ctx->tail;
@@ -23,47 +91,38 @@ size_t ringbuffer_len(rb_config_t *ctx) {
 }
 
 size_t ringbuffer_space(rb_config_t *ctx) {
-    return ctx->size - ringbuffer_len(ctx);
+    // One slot is kept open so a full buffer is never mistaken for empty (head == tail)
+    return ctx->size - 1 - ringbuffer_len(ctx);
 }
 
 size_t ringbuffer_push(rb_config_t *ctx, void *data, size_t len) {
-    for (size_t i = 0; i < len; i++) {
-        if (ringbuffer_space(ctx) == 0) {
-            return i;
-        }
-        memcpy(((char *)ctx->buffer) + ctx->head * ctx->dlen, ((char *)data) + i * ctx->dlen, ctx->dlen);
-        ctx->head = (ctx->head + 1) % ctx->size;
-    }
-    return len;
+    size_t space = ringbuffer_space(ctx);
+    size_t amt = len > space ? space : len;
+    if (amt == 0) { return 0; }
+    ctx->head = ringbuffer_write_at(ctx, ctx->head, data, amt);
+    return amt;
 }
 
 size_t ringbuffer_fill(rb_config_t *ctx, void* value, size_t len) {
     size_t space = ringbuffer_space(ctx);
     size_t amt = len > space ? space : len;
-    for (size_t i = 0; i < amt; i++) {
-        memcpy(((char *)ctx->buffer) + ctx->head * ctx->dlen, value, ctx->dlen);
-        ctx->head = (ctx->head + 1) % ctx->size;
+    size_t first = ctx->size - ctx->head;
+    if (amt == 0) { return 0; }
+    if (first > amt) { first = amt; }
+    ringbuffer_splat(((char *)ctx->buffer) + ctx->head * ctx->dlen, value, first, ctx->dlen);
+    if (amt > first) {
+        ringbuffer_splat(ctx->buffer, value, amt - first, ctx->dlen);
     }
+    ctx->head = ringbuffer_advance(ctx, ctx->head, amt);
     return amt;
 }
 
 size_t ringbuffer_pop(rb_config_t *ctx, void *data, size_t len) {
-    for (size_t i = 0; i < len; i++) {
-        if (ringbuffer_len(ctx) == 0) {
-            return i;
-        }
-        memcpy(((char *)data) + i * ctx->dlen, ((char *)ctx->buffer) + ctx->tail * ctx->dlen, ctx->dlen);
-        ctx->tail = (ctx->tail + 1) % ctx->size;
-    }
-    return len;
-}
-
-void
-ringbuffer_replace(rb_config_t *ctx, void *data, size_t len) {
-    for (size_t i = 0; i < len; i++) {
-        memcpy(((char *)ctx->buffer) + ctx->tail * ctx->dlen, ((char *)data) + i * ctx->dlen, ctx->dlen);
-        ctx->tail = (ctx->tail + 1) % ctx->size;
-    }
+    size_t size = ringbuffer_len(ctx);
+    size_t amt = len > size ? size : len;
+    if (amt == 0) { return 0; }
+    ctx->tail = ringbuffer_read_at(ctx, ctx->tail, data, amt);
+    return amt;
 }
 
 void
@@ -74,40 +133,40 @@ ringbuffer_reset(rb_config_t *ctx) {
 
 size_t
 ringbuffer_peek(rb_config_t *ctx, void *data, size_t len) {
-    size_t tail = ctx->tail;
-    for (size_t i = 0; i < len; i++) {
-        if (ringbuffer_len(ctx) == 0) {
-            return i;
-        }
-        memcpy(((char *)data) + i * ctx->dlen, ((char *)ctx->buffer) + tail * ctx->dlen, ctx->dlen);
-        tail = (tail + 1) % ctx->size;
-    }
-    return len;
+    size_t size = ringbuffer_len(ctx);
+    size_t amt = len > size ? size : len;
+    if (amt == 0) { return 0; }
+    ringbuffer_read_at(ctx, ctx->tail, data, amt);
+    return amt;
 }
 
 size_t
 ringbuffer_seek(rb_config_t *ctx, size_t len) {
     size_t size = ringbuffer_len(ctx);
     size_t amt = len > size ? size : len;
-    ctx->tail = (ctx->tail + amt) % ctx->size;
+    ctx->tail = ringbuffer_advance(ctx, ctx->tail, amt);
     return amt;
 }
 
 size_t
 ringbuffer_transfer(rb_config_t *src, rb_config_t *dst, size_t len) {
+    size_t size, space, amt, first;
     if (src->dlen != dst->dlen) {
         return 0;
     }
-    size_t size = ringbuffer_len(src);
-    size_t amt = len > size ? size : len;
-    for (size_t i = 0; i < amt; i++) {
-        if (ringbuffer_space(dst) == 0) {
-            return i;
-        }
-        memcpy(((char *)dst->buffer) + dst->head * dst->dlen, ((char *)src->buffer) + src->tail * src->dlen, src->dlen);
-        src->tail = (src->tail + 1) % src->size;
-        dst->head = (dst->head + 1) % dst->size;
+    size = ringbuffer_len(src);
+    space = ringbuffer_space(dst);
+    amt = len > size ? size : len;
+    amt = amt > space ? space : amt;
+    if (amt == 0) { return 0; }
+    // Source holds at most two contiguous segments- write each into destination
+    first = src->size - src->tail;
+    if (first > amt) { first = amt; }
+    dst->head = ringbuffer_write_at(dst, dst->head, ((char *)src->buffer) + src->tail * src->dlen, first);
+    if (amt > first) {
+        dst->head = ringbuffer_write_at(dst, dst->head, src->buffer, amt - first);
     }
+    src->tail = ringbuffer_advance(src, src->tail, amt);
     return amt;
 }
 
@@ -17,6 +17,7 @@ extern "C" {
 
 
 #include <stdint.h>
+#include <stddef.h>
 
 typedef struct {
     void *buffer;
@@ -64,10 +64,12 @@ ns_timer_config_t timerCfg = {
     .enableInterrupt = false
 };
 
+// Samples running task for cpuStats (callback set in main)
 ns_timer_config_t timer2Cfg = {
     .api = &ns_timer_V1_0_0,
     .timer = NS_TIMER_INTERRUPT,
-    .enableInterrupt = false
+    .enableInterrupt = true,
+    .periodInMicroseconds = CPU_STATS_PERIOD_US
 };
 
 
@@ -132,14 +134,7 @@ sensor_context_t sensorCtx = {
 };
 
 
-static float32_t ecgSensorBuffer[SENSOR_BUF_LEN];
-rb_config_t rbEcgSensor = {
-    .buffer = (void *)ecgSensorBuffer,
-    .dlen = sizeof(float32_t),
-    .size = SENSOR_BUF_LEN,
-    .head = 0,
-    .tail = 0,
-};
+RingBuffer<q15_t, SENSOR_BUF_LEN> rbEcgSensor;
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -165,6 +160,29 @@ static float32_t ecgSos[5 * ECG_SOS_LEN] = {
 arm_biquad_casd_df1_inst_f32 ecgFilterCtx = {.numStages = ECG_SOS_LEN, .pState = ecgSosState, .pCoeffs = ecgSos};
 
 
+///////////////////////////////////////////////////////////////////////////////
+// TFLM Configuration
+///////////////////////////////////////////////////////////////////////////////
+
+// Models take turns on the shared activation arena (tflm_arena_lock)
+static constexpr int sharedTensorArenaSize = 1024 * TFLM_SHARED_ARENA_SIZE_KB;
+alignas(16) static uint8_t sharedTensorArena[sharedTensorArenaSize];
+
+#if defined(TFLM_MODEL_SLOT)
+// Flatbuffer received over Tileio (TIO_MODEL_SLOT)
+static constexpr int modelSlotSize = 1024 * TFLM_MODEL_SLOT_SIZE_KB;
+alignas(16) static uint8_t modelSlotBuffer[modelSlotSize];
+model_slot_t modelSlot = {
+    .buffer = modelSlotBuffer,
+    .size = modelSlotSize,
+    .state = ModelSlotEmpty,
+    .stage = 0,
+    .len = 0,
+    .received = 0,
+};
+#endif
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // ECG Denoise Configuration
 ///////////////////////////////////////////////////////////////////////////////
@@ -177,23 +195,23 @@ float32_t ecgDenNoise[ECG_DEN_WINDOW_LEN];
 static constexpr int denTensorArenaSize = 1024 * ECG_DEN_MODEL_SIZE_KB;
 alignas(16) static uint8_t denTensorArena[denTensorArenaSize];
 tf_model_context_t ecgDenModelCtx = {
+    .name = "DEN",
     .arenaSize = denTensorArenaSize,
     .arena = denTensorArena,
+    .sharedArenaSize = sharedTensorArenaSize,
+    .sharedArena = sharedTensorArena,
+    .allocator = nullptr,
     .buffer = ecg_denoise_flatbuffer,
+    .check_io = ecg_denoise_check_io,
     .model = nullptr,
     .input = nullptr,
     .output = nullptr,
     .interpreter = nullptr,
 };
 
-static float32_t ecgDenBuffer[ECG_DEN_BUF_LEN];
-rb_config_t rbEcgDen = {
-    .buffer = (void *)ecgDenBuffer,
-    .dlen = sizeof(float32_t),
-    .size = ECG_DEN_BUF_LEN,
-    .head = 0,
-    .tail = 0,
-};
+q15_t ecgDenBatchOut[ECG_DEN_BATCH_LEN];
+// Batch windows are viewed one at a time (view_at) so V covers one window
+WaitableRingBuffer<q15_t, ECG_DEN_BUF_LEN, ECG_DEN_WINDOW_LEN> rbEcgDen;
 
 ///////////////////////////////////////////////////////////////////////////////
 // ECG Arrhythmia Configuration
@@ -205,9 +223,14 @@ float32_t ecgArrInout[ECG_ARR_WINDOW_LEN];
 static constexpr int arrTensorArenaSize = 1024 * ECG_ARR_MODEL_SIZE_KB;
 alignas(16) static uint8_t arrTensorArena[arrTensorArenaSize];
 tf_model_context_t ecgArrModelCtx = {
+    .name = "ARR",
     .arenaSize = arrTensorArenaSize,
     .arena = arrTensorArena,
+    .sharedArenaSize = sharedTensorArenaSize,
+    .sharedArena = sharedTensorArena,
+    .allocator = nullptr,
     .buffer = ecg_arrhythmia_flatbuffer,
+    .check_io = ecg_arrhythmia_check_io,
     .model = nullptr,
     .input = nullptr,
     .output = nullptr,
@@ -225,32 +248,23 @@ uint16_t ecgSegMask[ECG_SEG_WINDOW_LEN];
 static constexpr int segTensorArenaSize = 1024 * ECG_SEG_MODEL_SIZE_KB;
 alignas(16) static uint8_t segTensorArena[segTensorArenaSize];
 tf_model_context_t ecgSegModelCtx = {
+    .name = "SEG",
     .arenaSize = segTensorArenaSize,
     .arena = segTensorArena,
+    .sharedArenaSize = sharedTensorArenaSize,
+    .sharedArena = sharedTensorArena,
+    .allocator = nullptr,
     .buffer = ecg_segmentation_flatbuffer,
+    .check_io = ecg_segmentation_check_io,
     .model = nullptr,
     .input = nullptr,
     .output = nullptr,
     .interpreter = nullptr,
 };
 
-static float32_t ecgRawSegBuffer[ECG_SEG_BUF_LEN];
-rb_config_t rbEcgRawSeg = {
-    .buffer = (void *)ecgRawSegBuffer,
-    .dlen = sizeof(float32_t),
-    .size = ECG_SEG_BUF_LEN,
-    .head = 0,
-    .tail = 0,
-};
+RingBuffer<q15_t, ECG_SEG_BUF_LEN> rbEcgRawSeg;
 
-static float32_t ecgSegBuffer[ECG_SEG_BUF_LEN];
-rb_config_t rbEcgSeg = {
-    .buffer = (void *)ecgSegBuffer,
-    .dlen = sizeof(float32_t),
-    .size = ECG_SEG_BUF_LEN,
-    .head = 0,
-    .tail = 0,
-};
+WaitableRingBuffer<q15_t, ECG_SEG_BUF_LEN, ECG_SEG_WINDOW_LEN> rbEcgSeg;
 
 static float32_t ecgPkPeakState[4 * ECG_SEG_WINDOW_LEN];
 ecg_peak_f32_t ecgPkPeakCtx = {
@@ -277,27 +291,11 @@ static float32_t pkArena[5*ECG_MET_BUF_LEN];
 // ECG Metrics Configuration
 ///////////////////////////////////////////////////////////////////////////////
 
-static float32_t ecgMetRBuffer[ECG_MET_BUF_LEN];
-rb_config_t rbEcgMet = {
-    .buffer = (void *)ecgMetRBuffer,
-    .dlen = sizeof(float32_t),
-    .size = ECG_MET_BUF_LEN,
-    .head = 0,
-    .tail = 0,
-};
-
-static uint16_t ecgMaskMetRBuffer[ECG_MET_BUF_LEN];
-rb_config_t rbEcgMaskMet = {
-    .buffer = (void *)ecgMaskMetRBuffer,
-    .dlen = sizeof(uint16_t),
-    .size = ECG_MET_BUF_LEN,
-    .head = 0,
-    .tail = 0,
-};
+WaitableBroadcastRingBuffer<tio_ecg_frame_t, ECG_MET_BUF_LEN, EcgNumReaders, 0, 1 << EcgReaderTx> rbEcgSegOut;
+static_assert(sizeof(tio_ecg_frame_t) == 3 * sizeof(int16_t), "tio_ecg_frame_t must be packed");
 
-float32_t ecgMetData[ECG_MET_WINDOW_LEN];
-float32_t ecgDenMetData[ECG_MET_WINDOW_LEN];
-uint16_t ecgMaskMetData[ECG_MET_WINDOW_LEN];
+float32_t ecgMetInout[ECG_MET_WINDOW_LEN];
+uint16_t ecgMetMask[ECG_MET_WINDOW_LEN];
 
 hrv_td_metrics_t ecgHrvMetrics;
 metrics_app_results_t appMetResults = {
@@ -315,31 +313,40 @@ metrics_app_results_t appMetResults = {
 // TileIO Configuration
 ///////////////////////////////////////////////////////////////////////////////
 
-static float32_t ecgRawTxBuffer[ECG_TX_BUF_LEN];
-rb_config_t rbEcgRawTx = {
-    .buffer = (void *)ecgRawTxBuffer,
-    .dlen = sizeof(float32_t),
-    .size = ECG_TX_BUF_LEN,
-    .head = 0,
-    .tail = 0,
-};
+latency_clock_t ecgLatClock = {};
+latency_hist_t latencyHists[LatencyNumPoints] = {};
 
-static float32_t ecgDenTxBuffer[ECG_TX_BUF_LEN];
-rb_config_t rbEcgDenTx = {
-    .buffer = (void *)ecgDenTxBuffer,
-    .dlen = sizeof(float32_t),
-    .size = ECG_TX_BUF_LEN,
-    .head = 0,
-    .tail = 0,
-};
 
-static uint16_t ecgMaskTxBuffer[ECG_TX_BUF_LEN];
-rb_config_t rbEcgMaskTx = {
-    .buffer = (void *)ecgMaskTxBuffer,
-    .dlen = sizeof(uint16_t),
-    .size = ECG_TX_BUF_LEN,
-    .head = 0,
-    .tail = 0,
+///////////////////////////////////////////////////////////////////////////////
+// Governor Configuration
+///////////////////////////////////////////////////////////////////////////////
+
+// Segmentation and arrhythmia stay >= DSP as metrics rely on the mask
+governor_stage_t stageGovernors[PipelineNumStages] = {
+    {
+        .minMode = DenoiseModeOff,
+        .degradeBacklog = GOV_DEGRADE_BACKLOG,
+        .degradeUs = GOV_HOP_BUDGET_US(ECG_DEN_VALID_LEN),
+        .restoreRuns = GOV_RESTORE_RUNS,
+        .requestedMode = DenoiseModeAi,
+        .mode = DenoiseModeAi,
+    },
+    {
+        .minMode = SegmentationModeDsp,
+        .degradeBacklog = GOV_DEGRADE_BACKLOG,
+        .degradeUs = GOV_HOP_BUDGET_US(ECG_SEG_VALID_LEN),
+        .restoreRuns = GOV_RESTORE_RUNS,
+        .requestedMode = SegmentationModeAi,
+        .mode = SegmentationModeAi,
+    },
+    {
+        .minMode = ArrhythmiaModeDsp,
+        .degradeBacklog = GOV_DEGRADE_BACKLOG,
+        .degradeUs = GOV_HOP_BUDGET_US(ECG_MET_VALID_LEN),
+        .restoreRuns = GOV_RESTORE_RUNS,
+        .requestedMode = ArrhythmiaModeAi,
+        .mode = ArrhythmiaModeAi,
+    },
 };
 
 
@@ -370,4 +377,14 @@ app_state_t appState = {
     .segMode = SegmentationModeAi,
     .arrMode = ArrhythmiaModeAi,
     .ledState = 0,
+    .denPadLen = ECG_DEN_PAD_LEN,
+    .segPadLen = ECG_SEG_PAD_LEN,
+    .metHop = ECG_MET_VALID_LEN / ECG_MET_HOP_UNIT_LEN,
+};
+
+cpu_stats_t cpuStats = {
+    .numTasks = CpuNumTasks,
+    .tasks = {},
+    .idleTask = NULL,
+    .counts = {},
 };
@@ -28,7 +28,14 @@
 #include "sensor.h"
 #include "metrics.h"
 #include "ringbuffer.h"
+#include "typed_ringbuffer.h"
+#include "waitable_ringbuffer.h"
+#include "q15_ringbuffer.h"
+#include "governor.h"
+#include "latency.h"
+#include "cpu_stats.h"
 #include "tileio.h"
+#include "model_slot.h"
 
 
 enum HeartRhythm { HeartRhythmNormal, HeartRhythmAfib, HeartRhythmAfut };
@@ -52,6 +59,22 @@ typedef enum SegmentationMode SegmentationMode;
 enum ArrhythmiaMode { ArrhythmiaModeOff, ArrhythmiaModeDsp, ArrhythmiaModeAi };
 typedef enum ArrhythmiaMode ArrhythmiaMode;
 
+enum PipelineRing { PipelineRingEcgDen, PipelineRingEcgRawSeg, PipelineRingEcgSeg, PipelineRingEcgSegOut };
+typedef enum PipelineRing PipelineRing;
+
+// Readers of rbEcgSegOut (TX is dropped rather than waited on)
+enum EcgReader { EcgReaderMet, EcgReaderTx, EcgNumReaders };
+typedef enum EcgReader EcgReader;
+
+enum PipelineStage { PipelineStageDenoise, PipelineStageSegmentation, PipelineStageMetrics, PipelineNumStages };
+typedef enum PipelineStage PipelineStage;
+
+enum LatencyPoint { LatencyPointDenoise, LatencyPointSegment, LatencyPointTx, LatencyNumPoints };
+typedef enum LatencyPoint LatencyPoint;
+
+enum CpuTask { CpuTaskSensor, CpuTaskDenoise, CpuTaskSegmentation, CpuTaskMetrics, CpuTaskTx, CpuTaskTio, CpuNumTasks };
+typedef enum CpuTask CpuTask;
+
 typedef struct {
     uint8_t inputSource; // cycle, PT1, PT2, ..., Live
     uint8_t bwNoiseLevel; // 0 - 99
@@ -62,8 +85,21 @@ typedef struct {
     uint8_t segMode;  // 0: off, 1: dsp, 2: ai
     uint8_t arrMode;  // 0: off, 1: dsp, 2: ai
     uint8_t ledState; // use 3 bits to represent 3 LEDs
+    uint8_t denPadLen; // 0 - ECG_DEN_MAX_PAD_LEN (hop = window - 2 * pad)
+    uint8_t segPadLen; // 0 - ECG_SEG_MAX_PAD_LEN (hop = window - 2 * pad)
+    uint8_t metHop;   // x ECG_MET_HOP_UNIT_LEN
 } app_state_t;
 
+/**
+ * @brief Slot0 (ECG) signal frame in Tileio wire format
+ *
+ */
+typedef struct {
+    int16_t mask; // Segmentation label
+    int16_t raw;  // Raw ECG * TIO_SLOT0_SCALE (saturated)
+    int16_t den;  // Denoised ECG * TIO_SLOT0_SCALE (saturated)
+} tio_ecg_frame_t;
+
 ///////////////////////////////////////////////////////////////////////////////
 // EVB Configuration
 ///////////////////////////////////////////////////////////////////////////////
@@ -79,7 +115,7 @@ extern ns_button_config_t nsBtnCfg;
 ///////////////////////////////////////////////////////////////////////////////
 
 extern sensor_context_t sensorCtx;
-extern rb_config_t rbEcgSensor;
+extern RingBuffer<q15_t, SENSOR_BUF_LEN> rbEcgSensor; // STIMULUS_Q15_SCALE or SENSOR_Q15_SCALE (sensor)
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -89,6 +125,15 @@ extern rb_config_t rbEcgSensor;
 extern arm_biquad_casd_df1_inst_f32 ecgFilterCtx;
 
 
+///////////////////////////////////////////////////////////////////////////////
+// TFLM Configuration
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(TFLM_MODEL_SLOT)
+extern model_slot_t modelSlot;
+#endif
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // ECG Denoise Configuration
 ///////////////////////////////////////////////////////////////////////////////
@@ -97,7 +142,8 @@ extern tf_model_context_t ecgDenModelCtx;
 extern float32_t ecgDenScratch[ECG_DEN_WINDOW_LEN];
 extern float32_t ecgDenInout[ECG_DEN_WINDOW_LEN];
 extern float32_t ecgDenNoise[ECG_DEN_WINDOW_LEN];
-extern rb_config_t rbEcgDen;
+extern q15_t ecgDenBatchOut[ECG_DEN_BATCH_LEN]; // ECG_Q15_SCALE
+extern WaitableRingBuffer<q15_t, ECG_DEN_BUF_LEN, ECG_DEN_WINDOW_LEN> rbEcgDen; // As rbEcgSensor
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -116,8 +162,8 @@ extern tf_model_context_t ecgSegModelCtx;
 extern float32_t ecgSegScratch[ECG_SEG_WINDOW_LEN];
 extern float32_t ecgSegInout[ECG_SEG_WINDOW_LEN];
 extern uint16_t ecgSegMask[ECG_SEG_WINDOW_LEN];
-extern rb_config_t rbEcgRawSeg;
-extern rb_config_t rbEcgSeg;
+extern RingBuffer<q15_t, ECG_SEG_BUF_LEN> rbEcgRawSeg; // ECG_Q15_SCALE
+extern WaitableRingBuffer<q15_t, ECG_SEG_BUF_LEN, ECG_SEG_WINDOW_LEN> rbEcgSeg; // ECG_Q15_SCALE
 extern ecg_peak_f32_t ecgPkPeakCtx;
 
 
@@ -135,11 +181,10 @@ extern uint8_t rriMask[MAX_RR_PEAKS];
 // ECG Metrics Configuration
 ///////////////////////////////////////////////////////////////////////////////
 
-extern rb_config_t rbEcgMet;
-extern rb_config_t rbEcgMaskMet;
-
-extern float32_t ecgMetData[ECG_MET_WINDOW_LEN];
-extern uint16_t ecgMaskMetData[ECG_MET_WINDOW_LEN];
+// Segmentation output frames- written once, one cursor per EcgReader
+extern WaitableBroadcastRingBuffer<tio_ecg_frame_t, ECG_MET_BUF_LEN, EcgNumReaders, 0, 1 << EcgReaderTx> rbEcgSegOut;
+extern float32_t ecgMetInout[ECG_MET_WINDOW_LEN];
+extern uint16_t ecgMetMask[ECG_MET_WINDOW_LEN];
 
 extern hrv_td_metrics_t ecgHrvMetrics;
 
@@ -150,9 +195,16 @@ extern metrics_app_results_t appMetResults;
 // TILEIO Configuration
 ///////////////////////////////////////////////////////////////////////////////
 
-extern rb_config_t rbEcgRawTx;
-extern rb_config_t rbEcgDenTx;
-extern rb_config_t rbEcgMaskTx;
+// Capture time by rbEcgDen stream index and sensor -> LatencyPoint ages
+extern latency_clock_t ecgLatClock;
+extern latency_hist_t latencyHists[LatencyNumPoints];
+
+///////////////////////////////////////////////////////////////////////////////
+// Governor Configuration
+///////////////////////////////////////////////////////////////////////////////
+
+// Indexed by PipelineStage- modes track appState *Mode
+extern governor_stage_t stageGovernors[PipelineNumStages];
 
 ///////////////////////////////////////////////////////////////////////////////
 // APP Configuration
@@ -163,4 +215,7 @@ extern ns_timer_config_t timerCfg;
 extern ns_timer_config_t timer2Cfg;
 extern app_state_t appState;
 
+// Indexed by CpuTask, then other (unregistered tasks) and idle (CPU_STATS only)
+extern cpu_stats_t cpuStats;
+
 #endif // __APP_STORE_H
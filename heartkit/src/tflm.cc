@@ -4,13 +4,21 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <new>
 // neuralSPOT
 #include "ns_ambiqsuite_harness.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
+#if defined(TFLM_PROFILE)
+#include "am_mcu_apollo.h"
+#include "ns_perf_profile.h"
+#endif
 // TFLM
 #include "tensorflow/lite/micro/kernels/micro_ops.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
 #include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "tensorflow/lite/micro/micro_profiler.h"
+#include "tensorflow/lite/micro/micro_utils.h"
 #include "tensorflow/lite/micro/system_setup.h"
 #include "tensorflow/lite/micro/tflite_bridge/micro_error_reporter.h"
 #include "tensorflow/lite/schema/schema_generated.h"
@@ -19,17 +27,68 @@
 static TflmErrorReport *errorReporter = nullptr;
 static TflmOpResolver *appOpResolver = nullptr;
 static TflmProfiler *profiler = nullptr;
+// Kernel is built without mutexes- binary semaphore guards the shared arena
+static SemaphoreHandle_t sharedArenaSem = nullptr;
+
+#if defined(TFLM_PROFILE)
+static TflmProfiler modelProfilers[TFLM_PROFILE_MAX_MODELS];
+static tf_model_context_t *profiledModels[TFLM_PROFILE_MAX_MODELS];
+static uint32_t numProfiledModels = 0;
+
+uint32_t
+TflmOpProfiler::BeginEvent(const char *tag) {
+    uint32_t idx = opIdx++;
+    if (idx >= TFLM_PROFILE_MAX_OPS) {
+        return TFLM_PROFILE_MAX_OPS;
+    }
+    tags[idx] = tag;
+    startCycles[idx] = DWT->CYCCNT;
+    return idx;
+}
+
+void
+TflmOpProfiler::EndEvent(uint32_t handle) {
+    if (handle >= TFLM_PROFILE_MAX_OPS) {
+        return;
+    }
+    cycles[handle] += DWT->CYCCNT - startCycles[handle];
+    numOps = handle >= numOps ? handle + 1 : numOps;
+}
+
+void
+TflmOpProfiler::StartInvoke() {
+    opIdx = 0;
+    numInvokes++;
+}
+
+void
+TflmOpProfiler::Reset() {
+    for (uint32_t i = 0; i < TFLM_PROFILE_MAX_OPS; i++) {
+        cycles[i] = 0;
+    }
+    numOps = 0;
+    numInvokes = 0;
+}
+#endif
 
 uint32_t
 tflm_init() {
 
-    tflite::MicroErrorReporter micro_error_reporter;
+    // Outlives tflm_init- models report load errors at runtime
+    static tflite::MicroErrorReporter micro_error_reporter;
     errorReporter = &micro_error_reporter;
 
     tflite::InitializeTarget();
 
+#if defined(TFLM_PROFILE)
+    // DWT cycle counter for per-op profiling
+    ns_init_perf_profiler();
+    ns_start_perf_profiler();
+#endif
+
     static TflmOpResolver resolver;
 
+#if defined(TFLM_ALL_OPS)
     // Add all the ops to the resolver
     resolver.AddAbs();
     resolver.AddAdd();
@@ -144,15 +203,264 @@ tflm_init() {
     resolver.AddWhile();
     resolver.AddWindow();
     resolver.AddZerosLike();
+#else
+    if (tflm_add_ops(resolver)) {
+        return 1;
+    }
+#endif
 
     appOpResolver = &resolver;
+
+    sharedArenaSem = xSemaphoreCreateBinary();
+    if (sharedArenaSem == nullptr) {
+        return 1;
+    }
+    xSemaphoreGive(sharedArenaSem);
     return 0;
 }
 
-uint32_t
-tflm_init_model(tf_model_context_t *ctx){
+static uint32_t
+init_model(tf_model_context_t *ctx) {
     ctx->resolver = appOpResolver;
     ctx->reporter = errorReporter;
+#if defined(TFLM_PROFILE)
+    // Each model keeps its profiler across reloads
+    if (ctx->profiler == nullptr && numProfiledModels < TFLM_PROFILE_MAX_MODELS) {
+        ctx->profiler = &modelProfilers[numProfiledModels];
+        profiledModels[numProfiledModels++] = ctx;
+    }
+#else
     ctx->profiler = profiler;
+#endif
+    // Persistent tensors in model arena and activations in shared arena
+    ctx->allocator = tflite::MicroAllocator::Create(ctx->arena, ctx->arenaSize, ctx->sharedArena, ctx->sharedArenaSize);
+    return ctx->allocator == nullptr;
+}
+
+static uint32_t
+init_quant(const TfLiteTensor *tensor, tflm_quant_t *quant) {
+    quant->type = tensor->type;
+    quant->scale = 1.0f;
+    quant->invScale = 1.0f;
+    quant->zeroPoint = 0.0f;
+    if (tensor->type == kTfLiteFloat32) {
+        return 0;
+    }
+    if ((tensor->type != kTfLiteInt8 && tensor->type != kTfLiteInt16) ||
+        tensor->quantization.type != kTfLiteAffineQuantization || tensor->params.scale == 0.0f) {
+        return 1;
+    }
+    quant->scale = tensor->params.scale;
+    quant->invScale = 1.0f / tensor->params.scale;
+    quant->zeroPoint = tensor->params.zero_point;
     return 0;
 }
+
+static uint32_t
+init_io(tf_model_context_t *ctx) {
+    // Assume single input/output tensor
+    ctx->input = ctx->interpreter->input(0);
+    ctx->output = ctx->interpreter->output(0);
+#if defined(TFLM_PROFILE)
+    // Drop any events from AllocateTensors()
+    if (ctx->profiler != nullptr) {
+        ctx->profiler->Reset();
+    }
+#endif
+    return init_quant(ctx->input, &ctx->inputQuant) | init_quant(ctx->output, &ctx->outputQuant);
+}
+
+static uint32_t
+load_model(tf_model_context_t *ctx, const unsigned char *buffer) {
+    size_t bytesUsed;
+
+    // Initialize TFLM backend
+    if (init_model(ctx)) {
+        TF_LITE_REPORT_ERROR(ctx->reporter, "Arena allocator failed");
+        return 1;
+    }
+
+    // Load model
+    ctx->model = tflite::GetModel(buffer);
+    if (ctx->model->version() != TFLITE_SCHEMA_VERSION) {
+        TF_LITE_REPORT_ERROR(ctx->reporter, "Schema mismatch: given=%d != expected=%d.", ctx->model->version(), TFLITE_SCHEMA_VERSION);
+        return 1;
+    }
+
+    // Initialize interpreter
+    ctx->interpreter = new (ctx->interpreterBuf) tflite::MicroInterpreter(ctx->model, *(ctx->resolver), ctx->allocator, nullptr, ctx->profiler);
+
+    // Allocate tensors
+    if (ctx->interpreter->AllocateTensors() != kTfLiteOk) {
+        TF_LITE_REPORT_ERROR(ctx->reporter, "AllocateTensors() failed");
+        return 1;
+    }
+
+    // Check arena size
+    bytesUsed = ctx->interpreter->arena_used_bytes();
+    ns_lp_printf("[%s] Arena used: %d bytes (given %d + %d shared)\n", ctx->name, bytesUsed, ctx->arenaSize, ctx->sharedArenaSize);
+    if (bytesUsed > ctx->arenaSize + ctx->sharedArenaSize) {
+        TF_LITE_REPORT_ERROR(ctx->reporter, "Arena mismatch: given=%d < expected=%d bytes.", ctx->arenaSize + ctx->sharedArenaSize, bytesUsed);
+        return 1;
+    }
+
+    // Store input and output tensors and quantization
+    if (init_io(ctx)) {
+        TF_LITE_REPORT_ERROR(ctx->reporter, "Unsupported input/output tensor type");
+        return 1;
+    }
+    return ctx->check_io != nullptr ? ctx->check_io(ctx) : 0;
+}
+
+uint32_t
+tflm_model_load(tf_model_context_t *ctx, const unsigned char *buffer) {
+    tflm_model_unload(ctx);
+    if (load_model(ctx, buffer)) {
+        tflm_model_unload(ctx);
+        return 1;
+    }
+    return 0;
+}
+
+uint32_t
+tflm_model_verify(const unsigned char *buffer, size_t len) {
+    flatbuffers::Verifier verifier(buffer, len);
+    return tflite::VerifyModelBuffer(verifier) ? 0 : 1;
+}
+
+void
+tflm_model_unload(tf_model_context_t *ctx) {
+    if (ctx->interpreter != nullptr) {
+        ctx->interpreter->~MicroInterpreter();
+        ctx->interpreter = nullptr;
+    }
+    // Allocator lives in the model arena- recreated on next load
+    ctx->allocator = nullptr;
+    ctx->model = nullptr;
+    ctx->input = nullptr;
+    ctx->output = nullptr;
+}
+
+TfLiteStatus
+tflm_invoke(tf_model_context_t *ctx) {
+#if defined(TFLM_PROFILE)
+    if (ctx->profiler != nullptr) {
+        ctx->profiler->StartInvoke();
+    }
+#endif
+    return ctx->interpreter->Invoke();
+}
+
+#if defined(TFLM_PROFILE)
+uint32_t
+tflm_profile_records(tflm_op_record_t *records, uint32_t first, uint32_t maxRecords) {
+    uint32_t numRecords = 0;
+    uint64_t totalCycles;
+    TflmProfiler *prof;
+    for (uint32_t m = 0; m < numProfiledModels && numRecords < maxRecords; m++) {
+        prof = profiledModels[m]->profiler;
+        if (first >= prof->numOps) {
+            first -= prof->numOps;
+            continue;
+        }
+        totalCycles = 0;
+        for (uint32_t i = 0; i < prof->numOps; i++) {
+            totalCycles += prof->cycles[i];
+        }
+        for (uint32_t i = first; i < prof->numOps && numRecords < maxRecords; i++) {
+            records[numRecords].model = m;
+            records[numRecords].op = i;
+            records[numRecords].permille = totalCycles ? 1000 * prof->cycles[i] / totalCycles : 0;
+            records[numRecords].cycles = prof->numInvokes ? prof->cycles[i] / prof->numInvokes : 0;
+            numRecords++;
+        }
+        first = 0;
+    }
+    return numRecords;
+}
+
+void
+tflm_profile_log() {
+    tflm_op_record_t records[TFLM_PROFILE_MAX_OPS];
+    TflmProfiler *prof;
+    uint32_t numRecords;
+    for (uint32_t m = 0, first = 0; m < numProfiledModels; m++) {
+        prof = profiledModels[m]->profiler;
+        numRecords = tflm_profile_records(records, first, prof->numOps);
+        first += numRecords;
+        ns_lp_printf("<PROFILE model %d: %d invokes >\n", m, prof->numInvokes);
+        for (uint32_t i = 0; i < numRecords; i++) {
+            ns_lp_printf(
+                "%3d %-24s %10d cycles %3d.%d%%\n", i, prof->tags[i] ? prof->tags[i] : "?",
+                records[i].cycles, records[i].permille / 10, records[i].permille % 10
+            );
+        }
+    }
+}
+
+void
+tflm_profile_reset() {
+    for (uint32_t m = 0; m < numProfiledModels; m++) {
+        profiledModels[m]->profiler->Reset();
+    }
+}
+#endif
+
+void
+tflm_quantize_f32(const tflm_quant_t *quant, const float32_t *src, TfLiteTensor *tensor, uint32_t len) {
+    float32_t scaled[TFLM_QUANT_CHUNK_LEN];
+    q31_t q31[TFLM_QUANT_CHUNK_LEN];
+    float32_t fullScale, offset;
+    uint32_t n;
+    // Zero the tail past len (e.g. a 256 sample model on a 250 sample window)-
+    // the arena is shared so it otherwise holds another model's activations
+    uint32_t tailLen = tflite::ElementCount(*tensor->dims) - len;
+    if (quant->type == kTfLiteInt8) {
+        arm_fill_q7((q7_t)quant->zeroPoint, &tensor->data.int8[len], tailLen);
+    } else if (quant->type == kTfLiteInt16) {
+        arm_fill_q15((q15_t)quant->zeroPoint, &tensor->data.i16[len], tailLen);
+    } else {
+        arm_copy_f32(src, tensor->data.f, len);
+        arm_fill_f32(0.0f, &tensor->data.f[len], tailLen);
+        return;
+    }
+    // arm_float_to_q31 maps [-1, 1) -> q31 (saturating) so fold the type's full
+    // scale into scale and offset. arm_q31_to_q7/q15 floor, so +0.5 rounds.
+    fullScale = quant->type == kTfLiteInt8 ? 128.0f : 32768.0f;
+    offset = (quant->zeroPoint + 0.5f) / fullScale;
+    for (uint32_t i = 0; i < len; i += n) {
+        n = len - i < TFLM_QUANT_CHUNK_LEN ? len - i : TFLM_QUANT_CHUNK_LEN;
+        arm_scale_f32(&src[i], quant->invScale / fullScale, scaled, n);
+        arm_offset_f32(scaled, offset, scaled, n);
+        arm_float_to_q31(scaled, q31, n);
+        if (quant->type == kTfLiteInt8) {
+            arm_q31_to_q7(q31, &tensor->data.int8[i], n);
+        } else {
+            arm_q31_to_q15(q31, &tensor->data.i16[i], n);
+        }
+    }
+}
+
+void
+tflm_dequantize_f32(const tflm_quant_t *quant, const TfLiteTensor *tensor, uint32_t offset, float32_t *dst, uint32_t len) {
+    float32_t fullScale;
+    if (quant->type == kTfLiteInt8) {
+        arm_q7_to_float(tensor->data.int8 + offset, dst, len);
+        fullScale = 128.0f;
+    } else if (quant->type == kTfLiteInt16) {
+        arm_q15_to_float(tensor->data.i16 + offset, dst, len);
+        fullScale = 32768.0f;
+    } else {
+        arm_copy_f32(tensor->data.f + offset, dst, len);
+        return;
+    }
+    // arm_q7/q15_to_float yield q / fullScale
+    arm_scale_f32(dst, quant->scale * fullScale, dst, len);
+    arm_offset_f32(dst, -quant->zeroPoint * quant->scale, dst, len);
+}
+
+void
+tflm_arena_lock() { xSemaphoreTake(sharedArenaSem, portMAX_DELAY); }
+
+void
+tflm_arena_unlock() { xSemaphoreGive(sharedArenaSem); }
@@ -21,31 +21,222 @@
 #include "tensorflow/lite/micro/system_setup.h"
 #include "tensorflow/lite/micro/tflite_bridge/micro_error_reporter.h"
 #include "tensorflow/lite/schema/schema_generated.h"
+#include "tflm_ops.h"
 
-
+#if defined(TFLM_ALL_OPS)
 using TflmOpResolver = tflite::MicroMutableOpResolver<113>;
+#else
+// Only the ops used by the models (generated from src/*_flatbuffer.h)
+using TflmOpResolver = tflite::MicroMutableOpResolver<TFLM_NUM_OPS>;
+#endif
 using TflmErrorReport = tflite::MicroErrorReporter;
+
+#define TFLM_QUANT_CHUNK_LEN (32) // Quantize scratch (stack) per CMSIS-DSP pass
+
+#if defined(TFLM_PROFILE)
+#define TFLM_PROFILE_MAX_MODELS (4)
+#define TFLM_PROFILE_MAX_OPS (64) // Per model (ops past this are not profiled)
+
+/**
+ * @brief Per-op profile record in Tileio wire format
+ *
+ */
+typedef struct {
+    uint8_t model;     // Model index (init order: denoise, segmentation, arrhythmia)
+    uint8_t op;        // Op index in model graph
+    uint16_t permille; // Share of model invoke cycles
+    uint32_t cycles;   // Average cycles per invoke
+} tflm_op_record_t;
+
+/**
+ * @brief MicroProfiler that sums DWT cycles per op across invokes
+ * TFLM emits one event per op in graph order so the event index since
+ * StartInvoke() is the op index.
+ *
+ */
+class TflmOpProfiler : public tflite::MicroProfilerInterface {
+  public:
+    uint32_t BeginEvent(const char *tag) override;
+    void EndEvent(uint32_t handle) override;
+    void StartInvoke();
+    void Reset();
+
+    const char *tags[TFLM_PROFILE_MAX_OPS] = {};
+    uint64_t cycles[TFLM_PROFILE_MAX_OPS] = {};
+    uint32_t numOps = 0;
+    uint32_t numInvokes = 0;
+
+  private:
+    uint32_t startCycles[TFLM_PROFILE_MAX_OPS] = {};
+    uint32_t opIdx = 0;
+};
+using TflmProfiler = TflmOpProfiler;
+#else
 using TflmProfiler = tflite::MicroProfiler;
+#endif
 
+/**
+ * @brief Model input/output tensor format (resolved once at init)
+ *
+ */
 typedef struct {
-    size_t arenaSize;
+    TfLiteType type; // kTfLiteFloat32, kTfLiteInt8 or kTfLiteInt16
+    float32_t scale;
+    float32_t invScale;
+    float32_t zeroPoint;
+} tflm_quant_t;
+
+typedef struct tf_model_context tf_model_context_t;
+
+/**
+ * @brief Model runner
+ * Owns one interpreter (placement storage) that tflm_model_load() rebuilds
+ * for any flatbuffer at runtime. buffer is the built-in model.
+ *
+ */
+struct tf_model_context {
+    const char *name; // Log tag
+    size_t arenaSize; // Persistent tensors (this model only)
     uint8_t *arena;
+    size_t sharedArenaSize; // Activations (shared by all models, see tflm_arena_lock)
+    uint8_t *sharedArena;
+    tflite::MicroAllocator *allocator;
     const unsigned char *buffer;
+    uint32_t (*check_io)(const tf_model_context_t *ctx); // Model specific I/O shape check (optional)
     const tflite::Model *model;
     TfLiteTensor *input;
     TfLiteTensor *output;
+    tflm_quant_t inputQuant;
+    tflm_quant_t outputQuant;
     TflmErrorReport *reporter;
     TflmProfiler *profiler;
     TflmOpResolver *resolver;
-    tflite::MicroInterpreter *interpreter;
-} tf_model_context_t;
+    tflite::MicroInterpreter *interpreter; // Points into interpreterBuf once loaded
+    alignas(tflite::MicroInterpreter) uint8_t interpreterBuf[sizeof(tflite::MicroInterpreter)];
+};
 
 
 uint32_t
 tflm_init();
 
+/**
+ * @brief Load model flatbuffer (unloads current model first)
+ * Buffer must stay valid until the next load. AllocateTensors() plans into
+ * the shared arena so hold tflm_arena_lock() once other models may run.
+ *
+ * @param ctx Model context
+ * @param buffer Model flatbuffer (16 byte aligned)
+ * @return uint32_t 0 on success, 1 on failure (model left unloaded)
+ */
+uint32_t
+tflm_model_load(tf_model_context_t *ctx, const unsigned char *buffer);
+
+/**
+ * @brief Check flatbuffer structure before loading an untrusted model
+ * tflm_model_load() trusts every offset in the buffer- run this first on
+ * models not built into the image (e.g. received over Tileio).
+ *
+ * @param buffer Model flatbuffer (16 byte aligned)
+ * @param len Flatbuffer length
+ * @return uint32_t 0 if valid, 1 otherwise
+ */
+uint32_t
+tflm_model_verify(const unsigned char *buffer, size_t len);
+
+/**
+ * @brief Destroy interpreter and release model arena
+ *
+ * @param ctx Model context
+ */
+void
+tflm_model_unload(tf_model_context_t *ctx);
+
+/**
+ * @brief Run model (starts a profiled invoke in TFLM_PROFILE builds)
+ *
+ * @param ctx Model context
+ * @return TfLiteStatus
+ */
+TfLiteStatus
+tflm_invoke(tf_model_context_t *ctx);
+
+#if defined(TFLM_PROFILE)
+/**
+ * @brief Fill per-op profile records of all models
+ *
+ * @param records Records
+ * @param first Index of first record (ops of all models in init order)
+ * @param maxRecords Max records to fill
+ * @return uint32_t Number of records filled (0 once past the last op)
+ */
 uint32_t
-tflm_init_model(tf_model_context_t *ctx);
+tflm_profile_records(tflm_op_record_t *records, uint32_t first, uint32_t maxRecords);
+
+/**
+ * @brief Print per-op profile of all models (with op names)
+ *
+ */
+void
+tflm_profile_log();
+
+/**
+ * @brief Clear per-op profile of all models
+ *
+ */
+void
+tflm_profile_reset();
+#endif
+
+/**
+ * @brief Quantize float values into tensor (round to nearest and saturate)
+ * CMSIS-DSP scale, offset and float -> q31 -> q7/q15 passes over chunks.
+ * Tensor elements past len are set to 0.0 (the zero point).
+ *
+ * @param quant Tensor quantization
+ * @param src Float values
+ * @param tensor Destination tensor (written from index 0)
+ * @param len Number of values (<= tensor element count)
+ */
+void
+tflm_quantize_f32(const tflm_quant_t *quant, const float32_t *src, TfLiteTensor *tensor, uint32_t len);
+
+/**
+ * @brief Dequantize tensor values to float
+ * CMSIS-DSP q7/q15 -> float, scale and offset passes in place in dst.
+ *
+ * @param quant Tensor quantization
+ * @param tensor Source tensor
+ * @param offset First tensor index
+ * @param dst Float values
+ * @param len Number of values
+ */
+void
+tflm_dequantize_f32(const tflm_quant_t *quant, const TfLiteTensor *tensor, uint32_t offset, float32_t *dst, uint32_t len);
+
+/**
+ * @brief Take ownership of the shared activation arena
+ * Hold from writing model input until model output is read- any other
+ * model's Invoke() overwrites the arena. Only take it on the TFLM path
+ * (quantize, Invoke(), dequantize, model load) so DSP mode runs never wait.
+ *
+ * A plain binary semaphore (the kernel is built without mutexes so there is
+ * no priority inheritance). A waiting stage is delayed by at most one hold
+ * of a lower priority stage plus the DSP runs of the other stages above it
+ * that become ready meanwhile (their TFLM path blocks here too). Worst case
+ * is SegTask behind one arrhythmia hold and the DenTask DSP runs due within
+ * it (DenTask shares SegTask's priority, see DEN_TASK_PRIORITY).
+ * Sensor, TX and Tileio tasks preempt every stage either way.
+ *
+ */
+void
+tflm_arena_lock();
+
+/**
+ * @brief Release the shared activation arena
+ *
+ */
+void
+tflm_arena_unlock();
 
 
 #endif // __HK_TFLM_H
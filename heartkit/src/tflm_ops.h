@@ -0,0 +1,46 @@
+/**
+ * @file tflm_ops.h
+ * @brief TFLM ops used by HeartKit models
+ * Generated by make/gen_tflm_ops.py from:
+ *   ecg_arrhythmia_flatbuffer.h
+ *   ecg_denoise_flatbuffer.h
+ *   ecg_segmentation_flatbuffer.h
+ * Do not edit- rebuild after changing a model.
+ *
+ */
+#ifndef __HK_TFLM_OPS_H
+#define __HK_TFLM_OPS_H
+
+#define TFLM_NUM_OPS (15)
+
+#ifdef __cplusplus
+/**
+ * @brief Register model ops (op: max version used)
+ *
+ * @param resolver MicroMutableOpResolver with >= TFLM_NUM_OPS slots
+ * @return uint32_t 0 on success
+ */
+template <typename OpResolver>
+static inline uint32_t
+tflm_add_ops(OpResolver &resolver) {
+    uint32_t err = 0;
+    err |= resolver.AddConv2D() != kTfLiteOk; // CONV_2D: v3
+    err |= resolver.AddDepthwiseConv2D() != kTfLiteOk; // DEPTHWISE_CONV_2D: v3
+    err |= resolver.AddDequantize() != kTfLiteOk; // DEQUANTIZE: v2
+    err |= resolver.AddFullyConnected() != kTfLiteOk; // FULLY_CONNECTED: v4
+    err |= resolver.AddMaxPool2D() != kTfLiteOk; // MAX_POOL_2D: v2
+    err |= resolver.AddMean() != kTfLiteOk; // MEAN: v2
+    err |= resolver.AddMinimum() != kTfLiteOk; // MINIMUM: v2
+    err |= resolver.AddMul() != kTfLiteOk; // MUL: v2
+    err |= resolver.AddPack() != kTfLiteOk; // PACK: v1
+    err |= resolver.AddQuantize() != kTfLiteOk; // QUANTIZE: v1
+    err |= resolver.AddRelu() != kTfLiteOk; // RELU: v2
+    err |= resolver.AddReshape() != kTfLiteOk; // RESHAPE: v1
+    err |= resolver.AddShape() != kTfLiteOk; // SHAPE: v1
+    err |= resolver.AddSoftmax() != kTfLiteOk; // SOFTMAX: v2
+    err |= resolver.AddStridedSlice() != kTfLiteOk; // STRIDED_SLICE: v1
+    return err;
+}
+#endif
+
+#endif // __HK_TFLM_OPS_H
@@ -32,11 +32,13 @@
 #define TIO_USB_CRC_LEN 2
 #define TIO_USB_STOP_IDX 255
 #define TIO_USB_STOP_VAL 0xAA
-#define TIO_USB_UIO_BUF_LEN (8)
+#define TIO_USB_UIO_BUF_LEN (TIO_UIO_LEN)
+#define TIO_USB_UIO_MIN_LEN (8) // Older dashboards send 8 UIO bytes
 
 #define TIO_BLE_SLOT_SIG_BUF_LEN (242)
 #define TIO_BLE_SLOT_MET_BUF_LEN (242)
-#define TIO_BLE_UIO_BUF_LEN (8)
+#define TIO_BLE_UIO_BUF_LEN (TIO_UIO_LEN)
+#define TIO_BLE_UIO_MIN_LEN (TIO_USB_UIO_MIN_LEN)
 
 #define TIO_SLOT_SVC_UUID "eecb7db88b2d402cb995825538b49328"
 #define TIO_SLOT0_SIG_CHAR_UUID "5bca2754ac7e4a27a1270f328791057a"
@@ -53,6 +55,8 @@
 
 #define TIO_USB_RX_BUFSIZE (4096)
 #define TIO_USB_TX_BUFSIZE (4096)
+// Rx ring keeps one byte open- fits a full rx buffer behind a partial packet
+#define TIO_USB_RX_RING_LEN (TIO_USB_RX_BUFSIZE + TIO_USB_PACKET_LEN)
 
 ////////////////////////////////////////////////////////////////
 // Global variables
@@ -138,11 +142,11 @@ tio_device_id_to_serial_id(uint8_t *deviceId, char *serialId, size_t len)
 static uint8_t tioRxBuffer[TIO_USB_RX_BUFSIZE] = {0};
 static uint8_t tioTxBuffer[TIO_USB_TX_BUFSIZE] = {0};
 
-static uint8_t tioRxRingBufferData[TIO_USB_RX_BUFSIZE];
+static uint8_t tioRxRingBufferData[TIO_USB_RX_RING_LEN];
 static rb_config_t tioRxRingBuffer = {
     .buffer = (void *)tioRxRingBufferData,
     .dlen = sizeof(uint8_t),
-    .size = TIO_USB_RX_BUFSIZE,
+    .size = TIO_USB_RX_RING_LEN,
     .head = 0,
     .tail = 0,
 };
@@ -194,7 +198,7 @@ tio_usb_validate_packet(const uint8_t *buffer, uint32_t length)
         ns_lp_printf("Invalid data length for slot type %lu\n", slotType);
         return 1;
     }
-    if (slotType == 2 && dlen != TIO_USB_UIO_BUF_LEN)
+    if (slotType == 2 && (dlen < TIO_USB_UIO_MIN_LEN || dlen > TIO_USB_UIO_BUF_LEN))
     {
         ns_lp_printf("Invalid data length for UIO\n");
         return 1;
@@ -414,6 +418,12 @@ static ns_ble_characteristic_t *bleSlotMetChars[4] = {
 
 static ns_ble_characteristic_t bleUioChar;
 
+// ns_ble's Cordio write callback- characteristic write handlers are not given
+// the write length so it is captured here first (all writes run in TioTask).
+// Stays UINT16_MAX (full characteristic) if ns_ble left no callback to wrap.
+static attsWriteCback_t bleWriteCback = NULL;
+static uint16_t bleWriteLen = UINT16_MAX;
+
 static tio_ble_context_t tioBleCtx = {
     .pool = &bleWsfBuffers,
     .service = &bleService,
@@ -460,6 +470,28 @@ int tio_ble_notify_uio_handler(ns_ble_service_t *s, struct ns_ble_characteristic
     return NS_STATUS_SUCCESS;
 }
 
+static uint8_t
+tio_ble_write_cback(dmConnId_t connId, uint16_t handle, uint8_t operation, uint16_t offset, uint16_t len, uint8_t *pValue, attsAttr_t *pAttr)
+{
+    bleWriteLen = len;
+    return bleWriteCback(connId, handle, operation, offset, len, pValue, pAttr);
+}
+
+int tio_ble_slot_met_write_handler(ns_ble_service_t *s, struct ns_ble_characteristic *c, void *src)
+{
+    // Same as USB slot metrics
+    uint16_t length = bleWriteLen < c->valueLen ? bleWriteLen : c->valueLen;
+    memcpy(c->applicationValue, src, length);
+    for (uint8_t slot = 0; slot < 4; slot++)
+    {
+        if (c == bleSlotMetChars[slot] && gTioCtx->slot_update_cb != NULL)
+        {
+            gTioCtx->slot_update_cb(slot, 1, src, length);
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
 int tio_ble_uio_read_handler(ns_ble_service_t *s, struct ns_ble_characteristic *c, void *dest)
 {
     memcpy(dest, c->applicationValue, c->valueLen);
@@ -468,12 +500,19 @@ int tio_ble_uio_read_handler(ns_ble_service_t *s, struct ns_ble_characteristic *
 
 int tio_ble_uio_write_handler(ns_ble_service_t *s, struct ns_ble_characteristic *c, void *src)
 {
-    memcpy(c->applicationValue, src, c->valueLen);
+    // Same as USB UIO (older dashboards send 8 bytes)
+    uint16_t length = bleWriteLen < c->valueLen ? bleWriteLen : c->valueLen;
+    if (length < TIO_BLE_UIO_MIN_LEN)
+    {
+        ns_lp_printf("Invalid UIO data length\n");
+        return NS_STATUS_SUCCESS;
+    }
+    memcpy(c->applicationValue, src, length);
     if (c == tioBleCtx.uioChar)
     {
         if (gTioCtx->uio_update_cb != NULL)
         {
-            gTioCtx->uio_update_cb(src, c->valueLen);
+            gTioCtx->uio_update_cb(src, length);
         }
     }
     return NS_STATUS_SUCCESS;
@@ -519,7 +558,7 @@ tio_ble_send_slot_data(uint8_t slot, uint8_t slot_type, const uint8_t *data, uin
 static void
 tio_ble_send_uio(const uint8_t *data, uint32_t length)
 {
-    if (length != 8)
+    if (length != TIO_BLE_UIO_BUF_LEN)
     {
         ns_lp_printf("Invalid UIO data length\n");
         return;
@@ -548,8 +587,8 @@ tio_ble_service_init(void)
         1000, true, &(tioBleCtx.service->numAttributes));
     ns_ble_create_characteristic(
         tioBleCtx.slot0MetChar, TIO_SLOT0_MET_CHAR_UUID, tioBleCtx.slot0MetBuffer, TIO_BLE_SLOT_MET_BUF_LEN,
-        NS_BLE_READ | NS_BLE_NOTIFY,
-        NULL, NULL, &tio_ble_notify_met_handler,
+        NS_BLE_READ | NS_BLE_WRITE | NS_BLE_NOTIFY,
+        NULL, &tio_ble_slot_met_write_handler, &tio_ble_notify_met_handler,
         1000, true, &(tioBleCtx.service->numAttributes));
 
     ns_ble_create_characteristic(
@@ -559,8 +598,8 @@ tio_ble_service_init(void)
         1000, true, &(tioBleCtx.service->numAttributes));
     ns_ble_create_characteristic(
         tioBleCtx.slot1MetChar, TIO_SLOT1_MET_CHAR_UUID, tioBleCtx.slot1MetBuffer, TIO_BLE_SLOT_MET_BUF_LEN,
-        NS_BLE_READ | NS_BLE_NOTIFY,
-        NULL, NULL, &tio_ble_notify_met_handler,
+        NS_BLE_READ | NS_BLE_WRITE | NS_BLE_NOTIFY,
+        NULL, &tio_ble_slot_met_write_handler, &tio_ble_notify_met_handler,
         1000, true, &(tioBleCtx.service->numAttributes));
 
     ns_ble_create_characteristic(
@@ -570,8 +609,8 @@ tio_ble_service_init(void)
         1000, true, &(tioBleCtx.service->numAttributes));
     ns_ble_create_characteristic(
         tioBleCtx.slot2MetChar, TIO_SLOT2_MET_CHAR_UUID, tioBleCtx.slot2MetBuffer, TIO_BLE_SLOT_MET_BUF_LEN,
-        NS_BLE_READ | NS_BLE_NOTIFY,
-        NULL, NULL, &tio_ble_notify_met_handler,
+        NS_BLE_READ | NS_BLE_WRITE | NS_BLE_NOTIFY,
+        NULL, &tio_ble_slot_met_write_handler, &tio_ble_notify_met_handler,
         1000, true, &(tioBleCtx.service->numAttributes));
 
     ns_ble_create_characteristic(
@@ -581,8 +620,8 @@ tio_ble_service_init(void)
         1000, true, &(tioBleCtx.service->numAttributes));
     ns_ble_create_characteristic(
         tioBleCtx.slot3MetChar, TIO_SLOT3_MET_CHAR_UUID, tioBleCtx.slot3MetBuffer, TIO_BLE_SLOT_MET_BUF_LEN,
-        NS_BLE_READ | NS_BLE_NOTIFY,
-        NULL, NULL, tio_ble_notify_met_handler,
+        NS_BLE_READ | NS_BLE_WRITE | NS_BLE_NOTIFY,
+        NULL, &tio_ble_slot_met_write_handler, tio_ble_notify_met_handler,
         1000, true, &(tioBleCtx.service->numAttributes));
 
     // UIO
@@ -594,6 +633,13 @@ tio_ble_service_init(void)
 
     tioBleCtx.service->numCharacteristics = 9;
     ns_ble_create_service(tioBleCtx.service);
+    // Interpose on the write callback before the group is registered
+    bleWriteCback = tioBleCtx.service->writeCback;
+    if (bleWriteCback != NULL)
+    {
+        tioBleCtx.service->writeCback = &tio_ble_write_cback;
+        tioBleCtx.service->group.writeCback = &tio_ble_write_cback;
+    }
     ns_ble_add_characteristic(tioBleCtx.service, tioBleCtx.slot0SigChar);
     ns_ble_add_characteristic(tioBleCtx.service, tioBleCtx.slot0MetChar);
     ns_ble_add_characteristic(tioBleCtx.service, tioBleCtx.slot1SigChar);
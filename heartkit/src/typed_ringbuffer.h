@@ -0,0 +1,599 @@
+/**
+ * @file typed_ringbuffer.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Compile-time typed ring buffers (power-of-two capacity)
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __TYPED_RINGBUFFER_H
+#define __TYPED_RINGBUFFER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+
+/**
+ * @brief Ring buffer telemetry record (16 bytes, packed for Tileio)
+ *
+ */
+typedef struct {
+    uint16_t fill;          // Elements stored now
+    uint16_t highWatermark; // Max elements stored since init
+    uint32_t pushed;        // Elements accepted by push/fill
+    uint32_t dropped;       // Elements refused because ring was full
+    uint32_t wraps;         // Times head wrapped past end of store
+} rb_stats_t;
+
+/**
+ * @brief Backing store, mirror and copy helpers for the typed ring buffers
+ * Positions are free-running 32-bit counters and element index is
+ * (counter & (N - 1)), so no slot is reserved and no division is needed to
+ * wrap. When V > 0 the first V elements are mirrored past the end of the
+ * store, so any window of up to V elements is contiguous in memory.
+ *
+ * @tparam T Element type (trivially copyable)
+ * @tparam N Capacity in elements (power of two)
+ * @tparam V Max contiguous view length in elements (0 disables views)
+ */
+template <typename T, uint32_t N, uint32_t V>
+class RingStorage {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "RingBuffer capacity must be a power of two");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "RingBuffer requires lock-free 32-bit atomics");
+    static_assert(V <= N, "RingBuffer view length must not exceed capacity");
+
+public:
+    static constexpr uint32_t Capacity = N;
+    static constexpr uint32_t Mask = N - 1;
+    static constexpr uint32_t ViewLen = V;
+
+protected:
+    static size_t min(size_t a, size_t b) { return a < b ? a : b; }
+
+    /**
+     * @brief Update producer-side counters (producer only)
+     * Counters have a single writer so plain load/store suffices.
+     *
+     * @param h Head before push
+     * @param count Elements requested
+     * @param amt Elements accepted
+     * @param fill Elements stored after push
+     */
+    void record_push(uint32_t h, size_t count, size_t amt, uint32_t fill) {
+        statPushed.store(statPushed.load(std::memory_order_relaxed) + amt, std::memory_order_relaxed);
+        if (count > amt) {
+            statDropped.store(statDropped.load(std::memory_order_relaxed) + (count - amt), std::memory_order_relaxed);
+        }
+        if (amt > 0 && (h & Mask) + amt >= N) {
+            statWraps.store(statWraps.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        if (fill > statHighWatermark.load(std::memory_order_relaxed)) {
+            statHighWatermark.store(fill, std::memory_order_relaxed);
+        }
+    }
+
+    rb_stats_t make_stats(uint32_t fill) const {
+        rb_stats_t stats;
+        stats.fill = (uint16_t)min(fill, UINT16_MAX);
+        stats.highWatermark = (uint16_t)min(statHighWatermark.load(std::memory_order_relaxed), UINT16_MAX);
+        stats.pushed = statPushed.load(std::memory_order_relaxed);
+        stats.dropped = statDropped.load(std::memory_order_relaxed);
+        stats.wraps = statWraps.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void write(uint32_t pos, const T *data, size_t count) {
+        uint32_t idx = pos & Mask;
+        size_t first = min(count, N - idx);
+        memcpy(&buffer[idx], data, first * sizeof(T));
+        if (count > first) {
+            memcpy(&buffer[0], data + first, (count - first) * sizeof(T));
+        }
+        if constexpr (V > 0) {
+            // Refresh mirror of the written span that falls in [0, V)
+            if (idx < V) {
+                memcpy(&buffer[N + idx], &buffer[idx], min(first, V - idx) * sizeof(T));
+            }
+            if (count > first) {
+                memcpy(&buffer[N], &buffer[0], min(count - first, V) * sizeof(T));
+            }
+        }
+    }
+
+    void splat(uint32_t pos, const T &value, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t idx = (pos + i) & Mask;
+            buffer[idx] = value;
+            if constexpr (V > 0) {
+                if (idx < V) { buffer[N + idx] = value; }
+            }
+        }
+    }
+
+    void read(uint32_t pos, T *data, size_t count) const {
+        uint32_t idx = pos & Mask;
+        size_t first = min(count, N - idx);
+        memcpy(data, &buffer[idx], first * sizeof(T));
+        if (count > first) {
+            memcpy(data + first, &buffer[0], (count - first) * sizeof(T));
+        }
+    }
+
+    T *at(uint32_t pos) { return &buffer[pos & Mask]; }
+
+    T buffer[N + V];
+
+private:
+    std::atomic<uint32_t> statHighWatermark{0};
+    std::atomic<uint32_t> statPushed{0};
+    std::atomic<uint32_t> statDropped{0};
+    std::atomic<uint32_t> statWraps{0};
+};
+
+/**
+ * @brief Typed ring buffer with capacity N (power of two)
+ * Fill level is (head - tail).
+ *
+ * Safe for one producer task and one consumer task without locks: only the
+ * producer advances head (push/fill) and only the consumer advances tail
+ * (pop/peek/seek/transfer/flush). Each side publishes its counter with a
+ * release store after touching the data and reads the other side's counter
+ * with an acquire load.
+ *
+ * When V > 0 windows of up to V elements starting at (or past) tail can be
+ * read in place with view()/view_at() instead of copied out with peek().
+ *
+ * @tparam T Element type (trivially copyable)
+ * @tparam N Capacity in elements (power of two)
+ * @tparam V Max contiguous view length in elements (0 disables views)
+ */
+template <typename T, uint32_t N, uint32_t V = 0>
+class RingBuffer : public RingStorage<T, N, V> {
+    using Base = RingStorage<T, N, V>;
+    using Base::min;
+
+public:
+    /**
+     * @brief Number of elements stored
+     */
+    size_t len() const { return (uint32_t)(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire)); }
+
+    /**
+     * @brief Number of free elements
+     */
+    size_t space() const { return N - len(); }
+
+    /**
+     * @brief Telemetry snapshot (safe from any task)
+     */
+    rb_stats_t stats() const { return this->make_stats(len()); }
+
+    /**
+     * @brief Push data to ringbuffer
+     *
+     * @param data Data to push
+     * @param count Number of elements
+     * @return size_t Number of elements pushed
+     */
+    size_t push(const T *data, size_t count) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        size_t amt = min(count, N - (uint32_t)(h - tail.load(std::memory_order_acquire)));
+        this->write(h, data, amt);
+        head.store(h + amt, std::memory_order_release);
+        this->record_push(h, count, amt, (uint32_t)(h + amt - tail.load(std::memory_order_relaxed)));
+        return amt;
+    }
+
+    /**
+     * @brief Fill ringbuffer with value
+     *
+     * @param value Value to fill
+     * @param count Number of elements
+     * @return size_t Number of elements filled
+     */
+    size_t fill(const T &value, size_t count) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        size_t amt = min(count, N - (uint32_t)(h - tail.load(std::memory_order_acquire)));
+        this->splat(h, value, amt);
+        head.store(h + amt, std::memory_order_release);
+        this->record_push(h, count, amt, (uint32_t)(h + amt - tail.load(std::memory_order_relaxed)));
+        return amt;
+    }
+
+    /**
+     * @brief Pop data from ringbuffer
+     *
+     * @param data Buffer to store data
+     * @param count Number of elements
+     * @return size_t Number of elements popped
+     */
+    size_t pop(T *data, size_t count) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        size_t amt = min(count, (uint32_t)(head.load(std::memory_order_acquire) - t));
+        this->read(t, data, amt);
+        tail.store(t + amt, std::memory_order_release);
+        return amt;
+    }
+
+    /**
+     * @brief Read data w/o removing (peek)
+     *
+     * @param data Buffer to store data
+     * @param count Number of elements
+     * @return size_t Number of elements read
+     */
+    size_t peek(T *data, size_t count) const {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        size_t amt = min(count, (uint32_t)(head.load(std::memory_order_acquire) - t));
+        this->read(t, data, amt);
+        return amt;
+    }
+
+    /**
+     * @brief Contiguous read-only window at tail (consumer side)
+     * Points into the backing store- valid until the consumer seeks past it.
+     * Data must not be modified through the view.
+     *
+     * @param count Number of elements (<= V)
+     * @return T* Window start or nullptr if fewer than count elements stored
+     */
+    T *view(size_t count) { return view_at(0, count); }
+
+    /**
+     * @brief Contiguous read-only window offset elements past tail (consumer side)
+     * Lets overlapping windows (e.g. a batch hop apart) be read one at a
+     * time so V only needs to cover one window. Same lifetime as view().
+     *
+     * @param offset Elements past tail
+     * @param count Number of elements (<= V)
+     * @return T* Window start or nullptr if fewer than offset + count elements stored
+     */
+    T *view_at(size_t offset, size_t count) {
+        static_assert(V > 0, "RingBuffer views require V > 0");
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (count > V || offset + count > (uint32_t)(head.load(std::memory_order_acquire) - t)) {
+            return nullptr;
+        }
+        return this->at(t + offset);
+    }
+
+    /**
+     * @brief Increment tail without reading
+     *
+     * @param count Number of elements
+     * @return size_t Number of elements skipped
+     */
+    size_t seek(size_t count) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        size_t amt = min(count, (uint32_t)(head.load(std::memory_order_acquire) - t));
+        tail.store(t + amt, std::memory_order_release);
+        return amt;
+    }
+
+    /**
+     * @brief Transfer data to another ringbuffer of same element type
+     * Acts as consumer of this ringbuffer and producer of dst. Uses dst's own
+     * push so derived rings (e.g. WaitableRingBuffer) see the write.
+     *
+     * @param dst Destination ringbuffer
+     * @param count Number of elements
+     * @return size_t Number of elements transferred
+     */
+    template <typename Dst>
+    size_t transfer(Dst &dst, size_t count) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        size_t amt = min(min(count, (uint32_t)(head.load(std::memory_order_acquire) - t)), dst.space());
+        size_t first = min(amt, N - (t & Base::Mask));
+        dst.push(this->at(t), first);
+        if (amt > first) {
+            dst.push(this->at(0), amt - first);
+        }
+        tail.store(t + amt, std::memory_order_release);
+        return amt;
+    }
+
+    /**
+     * @brief Flush ringbuffer (consumer side)
+     *
+     * @return size_t Number of elements dropped
+     */
+    size_t flush() {
+        uint32_t h = head.load(std::memory_order_acquire);
+        size_t amt = (uint32_t)(h - tail.load(std::memory_order_relaxed));
+        tail.store(h, std::memory_order_release);
+        return amt;
+    }
+
+private:
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> tail{0};
+};
+
+/**
+ * @brief Single-producer ring buffer broadcast to R readers
+ * Each reader owns a cursor and consumes at its own pace. Data is written
+ * once and space is reclaimed when the slowest reader has moved past it.
+ *
+ * Readers whose bit is set in DropMask never hold back the producer: when
+ * one lags by more than the capacity its cursor is advanced past the
+ * overwritten span and the skipped count is added to dropped(). A reader
+ * that is dropped mid-pop retries from its new cursor.
+ *
+ * @tparam T Element type (trivially copyable)
+ * @tparam N Capacity in elements (power of two)
+ * @tparam R Number of readers
+ * @tparam V Max contiguous view length in elements (0 disables views)
+ * @tparam DropMask Bitmask of readers that are dropped rather than waited on
+ */
+template <typename T, uint32_t N, uint32_t R, uint32_t V = 0, uint32_t DropMask = 0>
+class BroadcastRingBuffer : public RingStorage<T, N, V> {
+    static_assert(R > 0 && R <= 32, "BroadcastRingBuffer supports 1 to 32 readers");
+    using Base = RingStorage<T, N, V>;
+    using Base::min;
+
+public:
+    static constexpr uint32_t NumReaders = R;
+
+    /**
+     * @brief Number of elements pending for reader
+     */
+    size_t len(uint32_t reader) const {
+        return (uint32_t)(head.load(std::memory_order_acquire) - cursors[reader].load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief Number of free elements (bounded by slowest non-droppable reader)
+     */
+    size_t space() const {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        return N - (uint32_t)(h - blocking_tail(h));
+    }
+
+    /**
+     * @brief Telemetry snapshot (fill is relative to slowest blocking reader)
+     */
+    rb_stats_t stats() const { return this->make_stats(N - space()); }
+
+    /**
+     * @brief Telemetry snapshot for one reader
+     * Fill is the reader's pending count and dropped adds the elements
+     * skipped while it lagged.
+     *
+     * @param reader Reader index
+     */
+    rb_stats_t stats(uint32_t reader) const {
+        rb_stats_t stats = this->make_stats(len(reader));
+        stats.dropped += dropped(reader);
+        return stats;
+    }
+
+    /**
+     * @brief Push data to all readers
+     *
+     * @param data Data to push
+     * @param count Number of elements
+     * @return size_t Number of elements pushed
+     */
+    size_t push(const T *data, size_t count) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        size_t amt = min(count, N - (uint32_t)(h - blocking_tail(h)));
+        drop_lagging(h + amt);
+        this->write(h, data, amt);
+        head.store(h + amt, std::memory_order_release);
+        this->record_push(h, count, amt, (uint32_t)(h + amt - blocking_tail(h + amt)));
+        return amt;
+    }
+
+    /**
+     * @brief Read data w/o removing (peek)
+     *
+     * @param reader Reader index
+     * @param data Buffer to store data
+     * @param count Number of elements
+     * @return size_t Number of elements read
+     */
+    size_t peek(uint32_t reader, T *data, size_t count) const { return peek_at(reader, 0, data, count); }
+
+    /**
+     * @brief Read data offset elements past reader cursor w/o removing
+     * Lets a window longer than V be read in chunks. Only stable for readers
+     * that are waited on (not in DropMask).
+     *
+     * @param reader Reader index
+     * @param offset Elements past cursor
+     * @param data Buffer to store data
+     * @param count Number of elements
+     * @return size_t Number of elements read
+     */
+    size_t peek_at(uint32_t reader, size_t offset, T *data, size_t count) const {
+        uint32_t t = cursors[reader].load(std::memory_order_relaxed);
+        uint32_t pending = head.load(std::memory_order_acquire) - t;
+        size_t amt = offset < pending ? min(count, pending - offset) : 0;
+        this->read(t + offset, data, amt);
+        return amt;
+    }
+
+    /**
+     * @brief Pop data for reader
+     *
+     * @param reader Reader index
+     * @param data Buffer to store data
+     * @param count Number of elements
+     * @return size_t Number of elements popped
+     */
+    size_t pop(uint32_t reader, T *data, size_t count) {
+        uint32_t t = cursors[reader].load(std::memory_order_relaxed);
+        size_t amt;
+        do {
+            amt = min(count, (uint32_t)(head.load(std::memory_order_acquire) - t));
+            this->read(t, data, amt);
+        } while (!cursors[reader].compare_exchange_weak(t, t + amt, std::memory_order_release, std::memory_order_relaxed));
+        return amt;
+    }
+
+    /**
+     * @brief Contiguous read-only window at reader cursor
+     * Points into the backing store- valid until the reader seeks past it
+     * (readers in DropMask may be overwritten meanwhile). Data must not be
+     * modified through the view.
+     *
+     * @param reader Reader index
+     * @param count Number of elements (<= V)
+     * @return T* Window start or nullptr if fewer than count elements pending
+     */
+    T *view(uint32_t reader, size_t count) {
+        static_assert(V > 0, "BroadcastRingBuffer views require V > 0");
+        uint32_t t = cursors[reader].load(std::memory_order_relaxed);
+        if (count > V || count > (uint32_t)(head.load(std::memory_order_acquire) - t)) {
+            return nullptr;
+        }
+        return this->at(t);
+    }
+
+    /**
+     * @brief Advance reader cursor without reading
+     *
+     * @param reader Reader index
+     * @param count Number of elements
+     * @return size_t Number of elements skipped
+     */
+    size_t seek(uint32_t reader, size_t count) {
+        uint32_t t = cursors[reader].load(std::memory_order_relaxed);
+        size_t amt;
+        do {
+            amt = min(count, (uint32_t)(head.load(std::memory_order_acquire) - t));
+        } while (!cursors[reader].compare_exchange_weak(t, t + amt, std::memory_order_release, std::memory_order_relaxed));
+        return amt;
+    }
+
+    /**
+     * @brief Flush pending elements for reader
+     *
+     * @param reader Reader index
+     * @return size_t Number of elements dropped
+     */
+    size_t flush(uint32_t reader) {
+        return seek(reader, N);
+    }
+
+    /**
+     * @brief Total elements skipped for a lagging reader
+     */
+    uint32_t dropped(uint32_t reader) const { return drops[reader].load(std::memory_order_relaxed); }
+
+private:
+    static constexpr bool droppable(uint32_t reader) { return (DropMask >> reader) & 1; }
+
+    /**
+     * @brief Cursor of slowest reader the producer must wait on
+     */
+    uint32_t blocking_tail(uint32_t h) const {
+        uint32_t maxLag = 0;
+        for (uint32_t r = 0; r < R; r++) {
+            if (droppable(r)) { continue; }
+            uint32_t lag = h - cursors[r].load(std::memory_order_acquire);
+            if (lag > maxLag) { maxLag = lag; }
+        }
+        return h - maxLag;
+    }
+
+    /**
+     * @brief Advance droppable readers that would be overwritten up to newHead
+     */
+    void drop_lagging(uint32_t newHead) {
+        if constexpr (DropMask != 0) {
+            for (uint32_t r = 0; r < R; r++) {
+                if (!droppable(r)) { continue; }
+                uint32_t t = cursors[r].load(std::memory_order_acquire);
+                while ((uint32_t)(newHead - t) > N) {
+                    uint32_t newTail = newHead - N;
+                    if (cursors[r].compare_exchange_weak(t, newTail, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        drops[r].fetch_add(newTail - t, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> cursors[R] = {};
+    std::atomic<uint32_t> drops[R] = {};
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// rb_config_t style shim so existing call sites read the same
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T, uint32_t N, uint32_t V>
+inline size_t ringbuffer_len(const RingBuffer<T, N, V> *ctx) { return ctx->len(); }
+
+template <typename T, uint32_t N, uint32_t V>
+inline size_t ringbuffer_space(const RingBuffer<T, N, V> *ctx) { return ctx->space(); }
+
+template <typename T, uint32_t N, uint32_t V>
+inline size_t ringbuffer_push(RingBuffer<T, N, V> *ctx, const T *data, size_t len) { return ctx->push(data, len); }
+
+template <typename T, uint32_t N, uint32_t V>
+inline size_t ringbuffer_fill(RingBuffer<T, N, V> *ctx, const T *value, size_t len) { return ctx->fill(*value, len); }
+
+template <typename T, uint32_t N, uint32_t V>
+inline size_t ringbuffer_pop(RingBuffer<T, N, V> *ctx, T *data, size_t len) { return ctx->pop(data, len); }
+
+template <typename T, uint32_t N, uint32_t V>
+inline size_t ringbuffer_peek(const RingBuffer<T, N, V> *ctx, T *data, size_t len) { return ctx->peek(data, len); }
+
+template <typename T, uint32_t N, uint32_t V>
+inline T *ringbuffer_view(RingBuffer<T, N, V> *ctx, size_t len) { return ctx->view(len); }
+
+template <typename T, uint32_t N, uint32_t V>
+inline T *ringbuffer_view_at(RingBuffer<T, N, V> *ctx, size_t offset, size_t len) { return ctx->view_at(offset, len); }
+
+template <typename T, uint32_t N, uint32_t V>
+inline size_t ringbuffer_seek(RingBuffer<T, N, V> *ctx, size_t len) { return ctx->seek(len); }
+
+template <typename T, uint32_t N, uint32_t V, typename Dst>
+inline size_t ringbuffer_transfer(RingBuffer<T, N, V> *src, Dst *dst, size_t len) { return src->transfer(*dst, len); }
+
+template <typename T, uint32_t N, uint32_t V>
+inline size_t ringbuffer_flush(RingBuffer<T, N, V> *ctx) { return ctx->flush(); }
+
+template <typename T, uint32_t N, uint32_t V>
+inline rb_stats_t ringbuffer_stats(const RingBuffer<T, N, V> *ctx) { return ctx->stats(); }
+
+// Broadcast readers address their own cursor
+
+template <typename T, uint32_t N, uint32_t R, uint32_t V, uint32_t D>
+inline size_t ringbuffer_len(const BroadcastRingBuffer<T, N, R, V, D> *ctx, uint32_t reader) { return ctx->len(reader); }
+
+template <typename T, uint32_t N, uint32_t R, uint32_t V, uint32_t D>
+inline size_t ringbuffer_push(BroadcastRingBuffer<T, N, R, V, D> *ctx, const T *data, size_t len) { return ctx->push(data, len); }
+
+template <typename T, uint32_t N, uint32_t R, uint32_t V, uint32_t D>
+inline size_t ringbuffer_pop(BroadcastRingBuffer<T, N, R, V, D> *ctx, uint32_t reader, T *data, size_t len) { return ctx->pop(reader, data, len); }
+
+template <typename T, uint32_t N, uint32_t R, uint32_t V, uint32_t D>
+inline size_t ringbuffer_peek(const BroadcastRingBuffer<T, N, R, V, D> *ctx, uint32_t reader, T *data, size_t len) { return ctx->peek(reader, data, len); }
+
+template <typename T, uint32_t N, uint32_t R, uint32_t V, uint32_t D>
+inline size_t ringbuffer_peek_at(const BroadcastRingBuffer<T, N, R, V, D> *ctx, uint32_t reader, size_t offset, T *data, size_t len) { return ctx->peek_at(reader, offset, data, len); }
+
+template <typename T, uint32_t N, uint32_t R, uint32_t V, uint32_t D>
+inline T *ringbuffer_view(BroadcastRingBuffer<T, N, R, V, D> *ctx, uint32_t reader, size_t len) { return ctx->view(reader, len); }
+
+template <typename T, uint32_t N, uint32_t R, uint32_t V, uint32_t D>
+inline size_t ringbuffer_seek(BroadcastRingBuffer<T, N, R, V, D> *ctx, uint32_t reader, size_t len) { return ctx->seek(reader, len); }
+
+template <typename T, uint32_t N, uint32_t R, uint32_t V, uint32_t D>
+inline size_t ringbuffer_flush(BroadcastRingBuffer<T, N, R, V, D> *ctx, uint32_t reader) { return ctx->flush(reader); }
+
+template <typename T, uint32_t N, uint32_t R, uint32_t V, uint32_t D>
+inline rb_stats_t ringbuffer_stats(const BroadcastRingBuffer<T, N, R, V, D> *ctx) { return ctx->stats(); }
+
+template <typename T, uint32_t N, uint32_t R, uint32_t V, uint32_t D>
+inline rb_stats_t ringbuffer_stats(const BroadcastRingBuffer<T, N, R, V, D> *ctx, uint32_t reader) { return ctx->stats(reader); }
+
+#endif // __TYPED_RINGBUFFER_H
@@ -0,0 +1,220 @@
+/**
+ * @file waitable_ringbuffer.h
+ * @author Adam Page (adam.page@ambiq.com)
+ * @brief Typed ring buffer a FreeRTOS task can block on
+ * @version 1.0
+ * @date 2024-10-01
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __WAITABLE_RINGBUFFER_H
+#define __WAITABLE_RINGBUFFER_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "typed_ringbuffer.h"
+
+/**
+ * @brief RingBuffer whose consumer can block until a fill level is reached
+ * The consumer arms a threshold and the producer sends a task notification
+ * only on the push that takes the fill from below to at-or-above it. The
+ * threshold disarms itself when it fires so each arm yields one notification.
+ *
+ * A consumer waiting on several rings can arm() each one and then block once
+ * on ulTaskNotifyTake().
+ *
+ * @tparam T Element type (trivially copyable)
+ * @tparam N Capacity in elements (power of two)
+ * @tparam V Max contiguous view length in elements (0 disables views)
+ */
+template <typename T, uint32_t N, uint32_t V = 0>
+class WaitableRingBuffer : public RingBuffer<T, N, V> {
+    using Base = RingBuffer<T, N, V>;
+
+public:
+    /**
+     * @brief Set task to notify (consumer side, call before arm/wait)
+     *
+     * @param task Consumer task handle
+     */
+    void set_waiter(TaskHandle_t task) { waiter = task; }
+
+    /**
+     * @brief Push data to ringbuffer and notify waiter if threshold crossed
+     *
+     * @param data Data to push
+     * @param count Number of elements
+     * @return size_t Number of elements pushed
+     */
+    size_t push(const T *data, size_t count) {
+        size_t amt = Base::push(data, count);
+        notify(amt);
+        return amt;
+    }
+
+    /**
+     * @brief Fill ringbuffer with value and notify waiter if threshold crossed
+     *
+     * @param value Value to fill
+     * @param count Number of elements
+     * @return size_t Number of elements filled
+     */
+    size_t fill(const T &value, size_t count) {
+        size_t amt = Base::fill(value, count);
+        notify(amt);
+        return amt;
+    }
+
+    /**
+     * @brief Arm threshold (consumer side)
+     *
+     * @param count Fill level to be notified at
+     * @return true if count elements are already stored (nothing armed)
+     */
+    bool arm(size_t count) {
+        threshold.store(count, std::memory_order_relaxed);
+        // Order threshold publish before fill read (pairs with notify)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (this->len() >= count) {
+            threshold.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Block until count elements are stored (consumer side)
+     *
+     * @param count Number of elements
+     * @param timeout Max ticks to block
+     * @return true if count elements are stored
+     */
+    bool wait(size_t count, TickType_t timeout) {
+        if (arm(count)) { return true; }
+        ulTaskNotifyTake(pdTRUE, timeout);
+        threshold.store(0, std::memory_order_relaxed);
+        return this->len() >= count;
+    }
+
+private:
+    void notify(size_t amt) {
+        // Order head publish before threshold read (pairs with arm)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint32_t thr = threshold.load(std::memory_order_relaxed);
+        size_t after = this->len();
+        if (thr == 0 || after < thr || after >= thr + amt) { return; }
+        if (threshold.compare_exchange_strong(thr, 0, std::memory_order_relaxed) && waiter != NULL) {
+            xTaskNotifyGive(waiter);
+        }
+    }
+
+    std::atomic<uint32_t> threshold{0};
+    TaskHandle_t waiter = NULL;
+};
+
+template <typename T, uint32_t N, uint32_t V>
+inline size_t ringbuffer_push(WaitableRingBuffer<T, N, V> *ctx, const T *data, size_t len) { return ctx->push(data, len); }
+
+template <typename T, uint32_t N, uint32_t V>
+inline size_t ringbuffer_fill(WaitableRingBuffer<T, N, V> *ctx, const T *value, size_t len) { return ctx->fill(*value, len); }
+
+template <typename T, uint32_t N, uint32_t V>
+inline bool ringbuffer_wait(WaitableRingBuffer<T, N, V> *ctx, size_t len, TickType_t timeout) { return ctx->wait(len, timeout); }
+
+/**
+ * @brief BroadcastRingBuffer whose readers can each block until a fill level
+ * Same protocol as WaitableRingBuffer with one waiter and threshold per
+ * reader, so each reader task is woken only by the push that takes its own
+ * pending count to its threshold.
+ *
+ * @tparam T Element type (trivially copyable)
+ * @tparam N Capacity in elements (power of two)
+ * @tparam R Number of readers
+ * @tparam V Max contiguous view length in elements (0 disables views)
+ * @tparam DropMask Bitmask of readers that are dropped rather than waited on
+ */
+template <typename T, uint32_t N, uint32_t R, uint32_t V = 0, uint32_t DropMask = 0>
+class WaitableBroadcastRingBuffer : public BroadcastRingBuffer<T, N, R, V, DropMask> {
+    using Base = BroadcastRingBuffer<T, N, R, V, DropMask>;
+
+public:
+    /**
+     * @brief Set task to notify for reader (call before arm/wait)
+     *
+     * @param reader Reader index
+     * @param task Reader task handle
+     */
+    void set_waiter(uint32_t reader, TaskHandle_t task) { waiters[reader] = task; }
+
+    /**
+     * @brief Push data to all readers and notify those whose threshold is crossed
+     *
+     * @param data Data to push
+     * @param count Number of elements
+     * @return size_t Number of elements pushed
+     */
+    size_t push(const T *data, size_t count) {
+        size_t amt = Base::push(data, count);
+        notify(amt);
+        return amt;
+    }
+
+    /**
+     * @brief Arm reader threshold
+     *
+     * @param reader Reader index
+     * @param count Pending count to be notified at
+     * @return true if count elements are already pending (nothing armed)
+     */
+    bool arm(uint32_t reader, size_t count) {
+        thresholds[reader].store(count, std::memory_order_relaxed);
+        // Order threshold publish before fill read (pairs with notify)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (this->len(reader) >= count) {
+            thresholds[reader].store(0, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Block reader task until count elements are pending
+     *
+     * @param reader Reader index
+     * @param count Number of elements
+     * @param timeout Max ticks to block
+     * @return true if count elements are pending
+     */
+    bool wait(uint32_t reader, size_t count, TickType_t timeout) {
+        if (arm(reader, count)) { return true; }
+        ulTaskNotifyTake(pdTRUE, timeout);
+        thresholds[reader].store(0, std::memory_order_relaxed);
+        return this->len(reader) >= count;
+    }
+
+private:
+    void notify(size_t amt) {
+        // Order head publish before threshold read (pairs with arm)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (uint32_t r = 0; r < R; r++) {
+            uint32_t thr = thresholds[r].load(std::memory_order_relaxed);
+            size_t after = this->len(r);
+            if (thr == 0 || after < thr || after >= thr + amt) { continue; }
+            if (thresholds[r].compare_exchange_strong(thr, 0, std::memory_order_relaxed) && waiters[r] != NULL) {
+                xTaskNotifyGive(waiters[r]);
+            }
+        }
+    }
+
+    std::atomic<uint32_t> thresholds[R] = {};
+    TaskHandle_t waiters[R] = {};
+};
+
+template <typename T, uint32_t N, uint32_t R, uint32_t V, uint32_t D>
+inline size_t ringbuffer_push(WaitableBroadcastRingBuffer<T, N, R, V, D> *ctx, const T *data, size_t len) { return ctx->push(data, len); }
+
+template <typename T, uint32_t N, uint32_t R, uint32_t V, uint32_t D>
+inline bool ringbuffer_wait(WaitableBroadcastRingBuffer<T, N, R, V, D> *ctx, uint32_t reader, size_t len, TickType_t timeout) { return ctx->wait(reader, len, timeout); }
+
+#endif // __WAITABLE_RINGBUFFER_H